@@ -17,12 +17,25 @@ SOURCES += \
         main.cpp \
         mainwindow.cpp \
     label_img.cpp \
-    cloud_labeler.cpp
+    cloud_labeler.cpp \
+    cloud_result_cache.cpp \
+    cloud_batch_journal.cpp \
+    label_snapshot_store.cpp \
+    image_cache.cpp \
+    trace.cpp
 
 HEADERS += \
         mainwindow.h \
     label_img.h \
-    cloud_labeler.h
+    cloud_labeler.h \
+    cloud_result_cache.h \
+    cloud_batch_journal.h \
+    label_snapshot_store.h \
+    image_cache.h \
+    trace.h
+
+# Chrome trace-event spans: qmake CONFIG+=trace (see trace.h)
+trace: DEFINES += YOLOLABEL_TRACE
 
 FORMS += \
         mainwindow.ui
@@ -39,8 +52,8 @@ exists($$ONNXRUNTIME_DIR/include) {
     }
     LIBS += -L$$ONNXRUNTIME_DIR/lib -lonnxruntime
     unix: QMAKE_RPATHDIR += $$ONNXRUNTIME_DIR/lib
-    SOURCES += yolo_detector.cpp
-    HEADERS += yolo_detector.h
+    SOURCES += yolo_detector.cpp hybrid_router.cpp label_work_queue.cpp
+    HEADERS += yolo_detector.h hybrid_router.h label_work_queue.h
 }
 
 # Default rules for deployment.
@@ -0,0 +1,219 @@
+#include "batch_labeler.h"
+#include "trace.h"
+
+#include <QCollator>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+BatchAutoLabeler::BatchAutoLabeler(const BatchLabelOptions& options)
+    : m_options(options)
+{
+    m_options.threads    = std::max(1, m_options.threads);
+    m_options.shardCount = std::max(1, m_options.shardCount);
+}
+
+bool BatchAutoLabeler::loadModels(QString* error)
+{
+    // Split the cores between detectors instead of oversubscribing them
+    const int cores    = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int intraOps = std::max(1, cores / m_options.threads);
+
+    m_detectors.clear();
+    for (int t = 0; t < m_options.threads; ++t) {
+        auto detector = std::make_unique<YoloDetector>();
+        std::string errorMsg;
+        if (!detector->loadModel(m_options.modelPath.toStdString(), errorMsg, intraOps)) {
+            if (error) *error = QString::fromStdString(errorMsg);
+            m_detectors.clear();
+            return false;
+        }
+        m_detectors.push_back(std::move(detector));
+    }
+    return true;
+}
+
+int BatchAutoLabeler::numClasses() const
+{
+    return m_detectors.empty() ? 0 : m_detectors.front()->getNumClasses();
+}
+
+BatchLabelStats BatchAutoLabeler::run(const Progress& progress)
+{
+    BatchLabelStats stats;
+    if (m_detectors.empty()) return stats;
+
+    // Every queue worker must see the same image list, or workers would
+    // claim different images under the same block number; sharding does not
+    // apply to a queue run.
+    const QStringList all    = listImages(m_options.imageDir);
+    const QStringList images = m_options.useQueue
+        ? all : shard(all, m_options.shardIndex, m_options.shardCount);
+    stats.images = images.size();
+
+    std::unique_ptr<LabelWorkQueue> queue;
+    if (m_options.useQueue) {
+        queue = std::make_unique<LabelWorkQueue>(m_options.imageDir, images,
+                                                 m_options.queueBlockSize);
+        queue->setLeaseMs(m_options.queueLeaseMs);
+        if (!m_options.workerId.isEmpty())
+            queue->setWorkerId(m_options.workerId);
+    }
+
+    QElapsedTimer wall;
+    wall.start();
+
+    std::mutex statsMutex;
+    auto merge = [&](const BatchLabelStats& delta) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.labeled  += delta.labeled;
+        stats.skipped  += delta.skipped;
+        stats.failed   += delta.failed;
+        stats.blocks   += delta.blocks;
+        stats.boxes    += delta.boxes;
+        stats.decodeMs += delta.decodeMs;
+        stats.inferMs  += delta.inferMs;
+        stats.writeMs  += delta.writeMs;
+        stats.wallMs    = wall.elapsed();
+        if (progress) progress(stats);
+    };
+
+    std::atomic<int> next{ 0 };
+    auto indexWorker = [&](YoloDetector& detector) {
+        for (int i = next++; i < images.size() && !m_cancel; i = next++)
+            merge(labelOne(detector, images[i]));
+    };
+
+    auto queueWorker = [&](YoloDetector& detector) {
+        while (!m_cancel) {
+            const LabelWorkQueue::Block block = queue->claimNext();
+            if (!block.isValid()) break;
+
+            QElapsedTimer sinceRenew;
+            sinceRenew.start();
+            for (const QString& path : block.images) {
+                if (m_cancel) break;
+                merge(labelOne(detector, path));
+                if (sinceRenew.elapsed() >= queue->renewIntervalMs()) {
+                    queue->renew(block);
+                    sinceRenew.restart();
+                }
+            }
+            if (m_cancel) {
+                queue->release(block);
+                break;
+            }
+            BatchLabelStats delta;
+            delta.blocks = queue->markDone(block) ? 1 : 0;
+            merge(delta);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(m_detectors.size());
+    for (auto& detector : m_detectors) {
+        if (queue) pool.emplace_back(queueWorker, std::ref(*detector));
+        else       pool.emplace_back(indexWorker, std::ref(*detector));
+    }
+    for (auto& t : pool)
+        t.join();
+
+    stats.wallMs = wall.elapsed();
+    return stats;
+}
+
+BatchLabelStats BatchAutoLabeler::labelOne(YoloDetector& detector, const QString& imagePath) const
+{
+    TRACE_SCOPE("BatchAutoLabeler", "labelOne");
+    BatchLabelStats delta;
+    const QString labelPath = labelPathFor(imagePath);
+    if (m_options.skipExisting && QFile::exists(labelPath)) {
+        delta.skipped = 1;
+        return delta;
+    }
+
+    QElapsedTimer stage;
+    stage.start();
+    const QImage img = detector.loadInputImage(imagePath);
+    delta.decodeMs = stage.restart();
+    if (img.isNull()) {
+        delta.failed = 1;
+        return delta;
+    }
+
+    const auto detections = detector.detect(
+        img, m_options.confThreshold, m_options.nmsIouThreshold);
+    delta.inferMs = stage.restart();
+
+    const QByteArray text = formatLabels(detections, detector.getNumClasses());
+    if (writeLabelsAtomically(labelPath, text)) {
+        delta.labeled = 1;
+        delta.boxes   = text.count('\n');
+    } else {
+        delta.failed = 1;
+    }
+    delta.writeMs = stage.elapsed();
+    return delta;
+}
+
+QStringList BatchAutoLabeler::listImages(const QString& dir)
+{
+    QCollator collator;
+    collator.setNumericMode(true);
+
+    QStringList files = QDir(dir).entryList(
+        QStringList() << "*.jpg" << "*.JPG" << "*.png" << "*.bmp", QDir::Files);
+    std::sort(files.begin(), files.end(), collator);
+
+    for (QString& f : files)
+        f = dir + "/" + f;
+    return files;
+}
+
+QStringList BatchAutoLabeler::shard(const QStringList& images, int index, int count)
+{
+    if (count <= 1) return images;
+    QStringList out;
+    out.reserve(images.size() / count + 1);
+    for (int i = index; i >= 0 && i < images.size(); i += count)
+        out.append(images[i]);
+    return out;
+}
+
+QString BatchAutoLabeler::labelPathFor(const QString& imagePath)
+{
+    const int dot = imagePath.lastIndexOf('.');
+    return (dot < 0 ? imagePath : imagePath.left(dot)) + ".txt";
+}
+
+QByteArray BatchAutoLabeler::formatLabels(const std::vector<DetectionResult>& detections,
+                                          int numClasses)
+{
+    // QByteArray::number ignores the C locale, which QCoreApplication sets
+    // from the environment, so decimals are always written with a '.'
+    QByteArray out;
+    out.reserve(static_cast<int>(detections.size()) * 48);
+    for (const auto& det : detections) {
+        if (det.classId < 0 || det.classId >= numClasses) continue;
+        const double cx = det.x + det.width / 2.0;
+        const double cy = det.y + det.height / 2.0;
+        out += QByteArray::number(det.classId) + ' '
+             + QByteArray::number(cx, 'f', 6) + ' '
+             + QByteArray::number(cy, 'f', 6) + ' '
+             + QByteArray::number(static_cast<double>(det.width), 'f', 6) + ' '
+             + QByteArray::number(static_cast<double>(det.height), 'f', 6) + '\n';
+    }
+    return out;
+}
+
+bool BatchAutoLabeler::writeLabelsAtomically(const QString& labelPath, const QByteArray& text)
+{
+    QSaveFile out(labelPath);
+    return out.open(QIODevice::WriteOnly)
+        && out.write(text) == text.size()
+        && out.commit();
+}
@@ -0,0 +1,87 @@
+#ifndef BATCH_LABELER_H
+#define BATCH_LABELER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "label_work_queue.h"
+#include "yolo_detector.h"
+
+struct BatchLabelOptions {
+    QString imageDir;
+    QString modelPath;
+    float   confThreshold  = 0.25f;
+    float   nmsIouThreshold = 0.45f;
+    int     threads        = 1;      // detector instances running in parallel
+    int     shardIndex     = 0;      // this process labels images i with
+    int     shardCount     = 1;      //   i % shardCount == shardIndex
+    bool    skipExisting   = false;  // leave images that already have a label
+
+    // Shared work queue in the dataset directory (see LabelWorkQueue). Any
+    // number of processes, GUI or headless, can join the same run. The queue
+    // always covers the whole dataset; shardIndex/shardCount are ignored.
+    bool    useQueue       = false;
+    int     queueBlockSize = LabelWorkQueue::DEFAULT_BLOCK_SIZE;
+    qint64  queueLeaseMs   = LabelWorkQueue::DEFAULT_LEASE_MS;
+    QString workerId;                // empty: LabelWorkQueue::defaultWorkerId()
+};
+
+struct BatchLabelStats {
+    int    images    = 0;   // images in this shard, or the whole queue
+    int    blocks    = 0;   // queue blocks finished by this process
+    int    labeled   = 0;   // label files written
+    int    skipped   = 0;   // already labeled (skipExisting)
+    int    failed    = 0;   // unreadable image or unwritable label
+    qint64 boxes     = 0;
+    qint64 wallMs    = 0;
+    qint64 decodeMs  = 0;   // summed over worker threads
+    qint64 inferMs   = 0;
+    qint64 writeMs   = 0;
+};
+
+// Widget-free batch auto-labeling for yololabel-cli. Each worker thread owns
+// a YoloDetector and pulls images off a shared index, so one process keeps
+// every core busy; shardIndex/shardCount split a dataset between processes
+// or machines sharing the same directory. Label files are written through
+// QSaveFile, so a killed worker never leaves a half-written label behind.
+// With useQueue the threads claim blocks from a LabelWorkQueue instead, so
+// processes that join or crash mid-run are balanced automatically.
+class BatchAutoLabeler {
+public:
+    explicit BatchAutoLabeler(const BatchLabelOptions& options);
+
+    // Loads one detector per thread. Must succeed before run().
+    bool loadModels(QString* error);
+    int  numClasses() const;
+
+    // Called from worker threads after every image; keep it cheap.
+    using Progress = std::function<void(const BatchLabelStats&)>;
+    BatchLabelStats run(const Progress& progress = Progress());
+
+    void cancel() { m_cancel = true; }
+
+    // Same file filter and natural sort as the GUI's image list.
+    static QStringList listImages(const QString& dir);
+    static QStringList shard(const QStringList& images, int index, int count);
+    static QString     labelPathFor(const QString& imagePath);
+    // YOLO label text, in the GUI's format. Boxes with a class id outside
+    // [0, numClasses) are dropped.
+    static QByteArray  formatLabels(const std::vector<DetectionResult>& detections,
+                                    int numClasses);
+    static bool        writeLabelsAtomically(const QString& labelPath,
+                                             const QByteArray& text);
+
+private:
+    BatchLabelStats labelOne(YoloDetector& detector, const QString& imagePath) const;
+
+    BatchLabelOptions                          m_options;
+    std::vector<std::unique_ptr<YoloDetector>> m_detectors;
+    std::atomic<bool>                          m_cancel{ false };
+};
+
+#endif // BATCH_LABELER_H
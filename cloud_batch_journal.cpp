@@ -0,0 +1,155 @@
+#include "cloud_batch_journal.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStandardPaths>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static void syncToDisk(QFile &f)
+{
+    f.flush();
+#ifdef Q_OS_WIN
+    _commit(f.handle());
+#else
+    ::fsync(f.handle());
+#endif
+}
+
+QStringList CloudBatchJournal::State::remaining() const
+{
+    QStringList out;
+    for (const QString &p : paths)
+        if (!done.contains(p))
+            out.append(p);
+    return out;
+}
+
+CloudBatchJournal::CloudBatchJournal(const QString &path)
+    : m_path(path)
+{
+}
+
+QString CloudBatchJournal::defaultPath()
+{
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return base.isEmpty() ? QString() : base + "/cloud_batch.journal";
+}
+
+void CloudBatchJournal::begin(const QStringList &paths, const QString &prompt,
+                              const QStringList &classes)
+{
+    if (!isEnabled()) return;
+    close();
+    QDir().mkpath(QFileInfo(m_path).path());
+    m_file = std::make_unique<QFile>(m_path);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_file.reset();
+        return;
+    }
+    append({ { "type",    "begin" },
+             { "paths",   QJsonArray::fromStringList(paths) },
+             { "prompt",  prompt },
+             { "classes", QJsonArray::fromStringList(classes) } }, true);
+}
+
+void CloudBatchJournal::resume()
+{
+    if (!isEnabled()) return;
+    close();
+    m_file = std::make_unique<QFile>(m_path);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Append))
+        m_file.reset();
+}
+
+void CloudBatchJournal::recordSubmitted(const QStringList &paths, const QList<qint64> &jobIds)
+{
+    QJsonArray ids;
+    for (qint64 id : jobIds)
+        ids.append(id);
+    append({ { "type", "submitted" }, { "paths", QJsonArray::fromStringList(paths) },
+             { "job_ids", ids } }, true);
+}
+
+void CloudBatchJournal::recordDone(const QString &path)
+{
+    append({ { "type", "done" }, { "path", path } }, false);
+}
+
+void CloudBatchJournal::finish()
+{
+    m_file.reset();       // the file is deleted; no point syncing it
+    m_unsynced = 0;
+    if (isEnabled())
+        QFile::remove(m_path);
+}
+
+void CloudBatchJournal::close()
+{
+    if (m_file && m_unsynced > 0)
+        syncToDisk(*m_file);
+    m_file.reset();
+    m_unsynced = 0;
+}
+
+void CloudBatchJournal::append(const QJsonObject &record, bool durable)
+{
+    if (!m_file) return;
+    m_file->write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    m_file->flush();
+    ++m_unsynced;
+    if (durable || m_unsynced >= SYNC_EVERY || !m_sinceSync.isValid()
+        || m_sinceSync.hasExpired(SYNC_INTERVAL_MS)) {
+        syncToDisk(*m_file);
+        m_unsynced = 0;
+        m_sinceSync.start();
+    }
+}
+
+CloudBatchJournal::State CloudBatchJournal::load() const
+{
+    State state;
+    if (!isEnabled()) return state;
+
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly)) return state;
+
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine();
+        if (!line.endsWith('\n')) break;           // torn final record
+        const QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) break;
+
+        const QJsonObject rec  = doc.object();
+        const QString     type = rec.value("type").toString();
+        if (type == "begin") {
+            state = State();
+            for (const QJsonValue &v : rec.value("paths").toArray())
+                state.paths.append(v.toString());
+            state.prompt = rec.value("prompt").toString();
+            for (const QJsonValue &v : rec.value("classes").toArray())
+                state.classes.append(v.toString());
+        } else if (type == "submitted") {
+            QStringList   paths;
+            QList<qint64> ids;
+            for (const QJsonValue &v : rec.value("paths").toArray())
+                paths.append(v.toString());
+            for (const QJsonValue &v : rec.value("job_ids").toArray())
+                ids.append(v.toVariant().toLongLong());
+            if (paths.size() == ids.size())
+                state.submitted.append(qMakePair(paths, ids));
+        } else if (type == "done") {
+            state.done.insert(rec.value("path").toString());
+        }
+    }
+
+    if (state.remaining().isEmpty())
+        return State();
+    return state;
+}
@@ -0,0 +1,73 @@
+#ifndef CLOUD_BATCH_JOURNAL_H
+#define CLOUD_BATCH_JOURNAL_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+// Append-only journal of one cloud batch run, so a run interrupted by a
+// crash or restart can be resumed: jobs the server already accepted are
+// polled and fetched instead of re-sent. Each state transition is one JSON
+// line, flushed to the OS before the call returns, so it survives an app
+// crash. "submitted" records are also fsynced at once, since losing one
+// means re-uploading its images; "done" records are fsynced in groups of
+// SYNC_EVERY or after SYNC_INTERVAL_MS, as a lost one only makes a resume
+// fetch that label again. A torn last line (crash mid-write) is ignored on
+// load.
+class CloudBatchJournal
+{
+public:
+    // Replayed contents of an unfinished run.
+    struct State
+    {
+        QStringList   paths;        // every image in the run, in order
+        QString       prompt;       // as set by the user (may be empty)
+        QStringList   classes;
+        QList<QPair<QStringList, QList<qint64>>> submitted;  // chunk paths and job IDs
+        QSet<QString> done;         // images whose label file was written
+
+        bool        isValid() const { return !paths.isEmpty(); }
+        QStringList remaining() const;
+    };
+
+    // An empty path disables the journal.
+    explicit CloudBatchJournal(const QString &path = defaultPath());
+
+    static QString defaultPath();
+
+    bool    isEnabled() const { return !m_path.isEmpty(); }
+    QString path() const      { return m_path; }
+
+    // Starts a new run, replacing any previous journal.
+    void begin(const QStringList &paths, const QString &prompt, const QStringList &classes);
+    // Reopens the existing journal for appending after load().
+    void resume();
+    void recordSubmitted(const QStringList &paths, const QList<qint64> &jobIds);
+    void recordDone(const QString &path);
+    // Run completed or was cancelled: nothing left to resume.
+    void finish();
+    // Stops writing but keeps the file for a later resume.
+    void close();
+
+    // Returns the unfinished run on disk, or an invalid State.
+    State load() const;
+
+    static constexpr int SYNC_EVERY       = 32;
+    static constexpr int SYNC_INTERVAL_MS = 1000;
+
+private:
+    void append(const QJsonObject &record, bool durable);
+
+    QString                m_path;
+    std::unique_ptr<QFile> m_file;
+    int                    m_unsynced = 0;   // records written since the last fsync
+    QElapsedTimer          m_sinceSync;
+};
+
+#endif // CLOUD_BATCH_JOURNAL_H
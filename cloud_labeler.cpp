@@ -1,15 +1,31 @@
 #include "cloud_labeler.h"
+#include "trace.h"
 
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QBuffer>
+#include <QPointer>
+#include <QRandomGenerator>
+#include <QThreadPool>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 
 CloudAutoLabeler::CloudAutoLabeler(QObject *parent)
     : QObject(parent)
     , m_net(new QNetworkAccessManager(this))
     , m_pollTimer(new QTimer(this))
+    , m_apiHost(QString::fromLatin1(API_HOST))
 {
-    m_pollTimer->setInterval(POLL_INTERVAL);
+    // Single-shot: schedulePoll() re-arms it for the earliest poll deadline.
+    m_pollTimer->setSingleShot(true);
+    m_pollTimer->setTimerType(Qt::PreciseTimer);
+    m_clock.start();
+    m_prepared.setMaxCost(UPLOAD_CACHE_BYTES);
     connect(m_pollTimer, &QTimer::timeout, this, [this]() {
         if (m_batchMode) pollBatch();
         else             pollSingle();
@@ -21,6 +37,31 @@ CloudAutoLabeler::CloudAutoLabeler(QObject *parent)
 void CloudAutoLabeler::setApiKey(const QString &apiKey) { m_apiKey = apiKey; }
 void CloudAutoLabeler::setPrompt(const QString &prompt)  { m_prompt = prompt; }
 void CloudAutoLabeler::setClasses(const QStringList &c)  { m_classes = c; }
+void CloudAutoLabeler::setApiHost(const QString &h)      { m_apiHost = h; }
+void CloudAutoLabeler::setMaxChunksInFlight(int n)       { m_maxChunksInFlight = qMax(1, n); }
+
+void CloudAutoLabeler::setResultCacheDirectory(const QString &dir) { m_resultCache = CloudResultCache(dir); }
+void CloudAutoLabeler::setJournalPath(const QString &path)          { m_journal = CloudBatchJournal(path); }
+void CloudAutoLabeler::setSnapshotDirectory(const QString &dir)     { m_snapshots.setDirectory(dir); }
+
+void CloudAutoLabeler::beginSnapshotRun() { if (!m_busy) m_snapshots.beginRun(); }
+void CloudAutoLabeler::endSnapshotRun()   { if (!m_busy) m_snapshots.endRun(); }
+
+void CloudAutoLabeler::snapshotLabel(const QString &labelPath, const QByteArray &newContents)
+{
+    m_snapshots.snapshot(labelPath, newContents);
+}
+
+void CloudAutoLabeler::setUploadPreparation(int maxSide, int quality, const QString &format)
+{
+    m_uploadMaxSide = qMax(0, maxSide);
+    m_uploadQuality = qBound(1, quality, 100);
+    m_uploadFormat  = format.toLower().toLatin1();
+    if (m_uploadFormat == "jpeg") m_uploadFormat = "jpg";
+    if (m_uploadFormat != "jpg"
+        && !QImageWriter::supportedImageFormats().contains(m_uploadFormat))
+        m_uploadFormat = "jpg";   // e.g. no WebP plugin installed
+}
 
 // ── Public actions ──────────────────────────────────────────────────────────
 
@@ -51,19 +92,171 @@ void CloudAutoLabeler::labelImages(const QStringList &imagePaths)
     m_batchMode  = true;
     m_batchTotal = imagePaths.size();
     m_batchDone  = 0;
-    m_batchChunks.clear();
-    m_batchJobIds.clear();
-    m_batchPaths.clear();
+    m_batchPending.clear();
+    m_activeChunks.clear();
+    m_resumedChunks.clear();
+
+    m_journal.begin(imagePaths, m_prompt, m_classes);
+    emit progress(0, m_batchTotal);
+    m_batchHashing = true;
+    hashForResultCache(imagePaths, [this, imagePaths]() {
+        m_batchHashing = false;
+        startBatch(imagePaths);
+    });
+}
+
+// Moves the given images ahead of everything not yet submitted: they go up
+// next, in a chunk of their own (batch), or next in the queue (single-image
+// flow), and their pending result fetches jump the fetch queue. Images
+// already submitted or done are unaffected.
+void CloudAutoLabeler::prioritize(const QStringList &imagePaths)
+{
+    // A single-image job has nothing to reorder
+    if (!m_busy || !m_batchMode || imagePaths.isEmpty()) return;
+    m_priorityPaths = imagePaths;   // also applied when chunks are formed
+
+    QStringList lane;
+    for (const QString &path : imagePaths)
+        if (m_batchPending.removeOne(path))
+            lane.append(path);
+    m_batchPending = lane + m_batchPending;
+
+    std::stable_partition(m_fetchQueue.begin(), m_fetchQueue.end(),
+                          [&](const QPair<ChunkPtr, int> &f) {
+        return imagePaths.contains(f.first->paths[f.second]);
+    });
+}
+
+void CloudAutoLabeler::keepUserLabel(const QString &imagePath)
+{
+    if (m_busy) m_userLabeled.insert(imagePath);
+}
+
+CloudBatchJournal::State CloudAutoLabeler::resumableBatch() const
+{
+    return m_journal.load();
+}
 
-    for (int i = 0; i < imagePaths.size(); i += BATCH_SIZE) {
-        QStringList chunk;
-        for (int j = i; j < qMin(i + BATCH_SIZE, imagePaths.size()); ++j)
-            chunk.append(imagePaths[j]);
-        m_batchChunks.append(chunk);
+void CloudAutoLabeler::discardResumableBatch()
+{
+    if (!m_busy) m_journal.finish();
+}
+
+// Continues the run recorded in the journal: jobs the server already
+// accepted are polled and fetched, everything else is submitted as usual.
+void CloudAutoLabeler::resumeBatch()
+{
+    if (m_busy) return;
+    const CloudBatchJournal::State state = m_journal.load();
+    if (!state.isValid()) return;
+
+    m_prompt   = state.prompt;
+    m_classes  = state.classes;
+    m_allPaths = state.paths;
+    setBusy(true);
+    m_cancelRequested = false;
+
+    m_batchMode  = true;
+    m_batchTotal = state.paths.size();
+    m_batchDone  = state.done.size();
+    m_batchPending.clear();
+    m_activeChunks.clear();
+    m_resumedChunks.clear();
+    m_journal.resume();
+
+    QSet<QString> submitted;
+    for (const auto &rec : state.submitted) {
+        auto chunk = std::make_shared<BatchChunk>();
+        for (int k = 0; k < rec.first.size(); ++k) {
+            const QString &path = rec.first[k];
+            if (state.done.contains(path) || submitted.contains(path)) continue;
+            submitted.insert(path);
+            chunk->paths.append(path);
+            chunk->jobIds.append(rec.second[k]);
+        }
+        if (chunk->paths.isEmpty()) continue;
+        m_resumedChunks.append(chunk);
     }
 
-    emit progress(0, m_batchTotal);
-    submitBatchChunk(m_batchChunks.takeFirst());
+    QStringList rest;
+    for (const QString &path : state.paths)
+        if (!state.done.contains(path) && !submitted.contains(path))
+            rest.append(path);
+
+    emit statusMessage(
+        QString("Resuming cloud auto-label: %1 job(s) on the server, %2 image(s) to submit.")
+            .arg(submitted.size()).arg(rest.size()), 4000);
+    emit progress(m_batchDone, m_batchTotal);
+
+    // Journaled jobs are polled while the rest is hashed; the flag keeps
+    // fillBatchWindow() from finishing the run before `rest` is queued.
+    m_batchHashing = true;
+    if (!m_resumedChunks.isEmpty())
+        fillBatchWindow();
+    hashForResultCache(rest, [this, rest]() {
+        m_batchHashing = false;
+        startBatch(rest);
+    });
+}
+
+// Resolves every image already in the result cache locally, then queues the
+// rest for upload; fillBatchWindow() cuts them into chunks.
+void CloudAutoLabeler::startBatch(const QStringList &paths)
+{
+    QStringList misses;
+    int         hits = 0;
+    for (const QString &imagePath : paths) {
+        QJsonObject cached;
+        if (m_resultCache.lookup(m_resultKeys.value(imagePath), cached)) {
+            writeBatchLabel(imagePath, jobResultFromCache(cached));
+            ++hits;
+        } else {
+            misses.append(imagePath);
+        }
+    }
+    if (hits > 0) {
+        emit statusMessage(
+            QString("Cloud auto-label: %1 image(s) reused from cache.").arg(hits), 3000);
+    }
+
+    // Images the user is looking at go first
+    QStringList lane;
+    for (const QString &path : std::as_const(m_priorityPaths))
+        if (misses.removeOne(path))
+            lane.append(path);
+    m_batchPending += lane + misses;
+
+    fillBatchWindow();
+}
+
+// Computes result cache keys for all paths on the global thread pool, then
+// calls `then` on this object's thread.
+void CloudAutoLabeler::hashForResultCache(const QStringList &paths, const std::function<void()> &then)
+{
+    if (!m_resultCache.isEnabled() || paths.isEmpty()) {
+        then();
+        return;
+    }
+
+    auto remaining = std::make_shared<int>(paths.size());
+    const int         gen     = m_generation;
+    const QString     prompt  = effectivePrompt();
+    const QStringList classes = m_classes;
+    QPointer<CloudAutoLabeler> self(this);
+
+    for (const QString &path : paths) {
+        QThreadPool::globalInstance()->start([self, path, prompt, classes, gen, remaining, then]() {
+            TRACE_SCOPE("cloud", "hashForResultCache");
+            const QByteArray key = CloudResultCache::key(
+                CloudResultCache::contentHash(path), prompt, classes);
+            if (!self) return;
+            QMetaObject::invokeMethod(self.data(), [self, path, key, gen, remaining, then]() {
+                if (self->m_generation != gen) return;
+                self->m_resultKeys.insert(path, key);
+                if (--(*remaining) == 0) then();
+            }, Qt::QueuedConnection);
+        });
+    }
 }
 
 void CloudAutoLabeler::cancel()
@@ -71,6 +264,7 @@ void CloudAutoLabeler::cancel()
     ++m_generation;          // invalidate all in-flight callbacks
     m_cancelRequested = true;
     m_pollTimer->stop();
+    if (m_batchMode) m_journal.finish();
     resetState();
     setBusy(false);
     emit statusMessage("Cloud auto-label cancelled.", 3000);
@@ -82,34 +276,49 @@ void CloudAutoLabeler::setBusy(bool busy)
 {
     if (m_busy == busy) return;
     m_busy = busy;
+    if (busy) {
+        if (!m_snapshots.isInRun())   // may have been opened by beginSnapshotRun()
+            m_snapshots.beginRun();
+    } else {
+        m_snapshots.endRun();
+        // The cache only grows during a run; trim it off the GUI thread.
+        if (m_resultCache.isEnabled())
+            QThreadPool::globalInstance()->start([cache = m_resultCache]() { cache.prune(); });
+    }
     emit busyChanged(busy);
 }
 
 void CloudAutoLabeler::resetState()
 {
     m_pollCount    = 0;
+    m_pollsInFlight  = 0;
+    m_pollPausedUntil = 0;
     m_pendingJobId = -1;
     m_pendingPath.clear();
     m_queue.clear();
     m_singleWriteOk = 0;
     m_singlePolling = false;
-    m_batchMode    = false;
-    m_batchPolling = false;
-    m_batchJobIds.clear();
-    m_batchJobStatuses.clear();
-    m_batchPaths.clear();
-    m_batchChunks.clear();
-    m_batchTotal              = 0;
-    m_batchDone               = 0;
-    m_batchFailed             = 0;
-    m_batchChunkWriteSucceeded = 0;
-    m_pollOffset              = 0;
+    m_batchMode      = false;
+    m_batchUploading = false;
+    m_batchHashing   = false;
+    m_activeChunks.clear();
+    m_resumedChunks.clear();
+    m_batchPending.clear();
+    m_fetchQueue.clear();
+    m_fetchesInFlight = 0;
+    m_resultKeys.clear();
+    m_priorityPaths.clear();
+    m_userLabeled.clear();
+    m_batchTotal     = 0;
+    m_batchDone      = 0;
+    m_batchFailed    = 0;
 }
 
 void CloudAutoLabeler::handleFatalError(const QString &message)
 {
     ++m_generation;  // invalidate all in-flight callbacks
     m_pollTimer->stop();
+    m_journal.close();   // keep it so the run can be resumed later
     resetState();
     setBusy(false);
     emit errorOccurred(message);
@@ -117,11 +326,111 @@ void CloudAutoLabeler::handleFatalError(const QString &message)
 
 QNetworkRequest CloudAutoLabeler::makeRequest(const QString &endpoint) const
 {
-    QNetworkRequest req(QUrl(QString::fromLatin1(API_HOST) + endpoint));
+    QNetworkRequest req(QUrl(m_apiHost + endpoint));
     req.setRawHeader("Authorization", ("Bearer " + m_apiKey).toUtf8());
     return req;
 }
 
+// Delay before the next status poll of a job that has been polled
+// `attempt` times: starts short so fast jobs are picked up quickly, then
+// backs off exponentially. Jitter spreads polls of jobs submitted together.
+int CloudAutoLabeler::nextPollDelay(int attempt)
+{
+    const double base   = INITIAL_POLL_INTERVAL * std::pow(POLL_BACKOFF, qMax(0, attempt));
+    const double capped = qMin(base, double(MAX_POLL_INTERVAL));
+    const double jitter = 1.0 + POLL_JITTER * (2.0 * QRandomGenerator::global()->generateDouble() - 1.0);
+    return qBound(1, int(capped * jitter), MAX_POLL_INTERVAL);
+}
+
+// Parses a Retry-After header value, either delay-seconds or an HTTP-date.
+// Returns the wait in ms, or -1 when the value is missing or malformed.
+int CloudAutoLabeler::parseRetryAfter(const QByteArray &value, const QDateTime &now)
+{
+    const QByteArray v = value.trimmed();
+    if (v.isEmpty()) return -1;
+
+    bool ok = false;
+    const int seconds = v.toInt(&ok);
+    if (ok) return seconds < 0 ? -1 : seconds * 1000;
+
+    const QDateTime at = QDateTime::fromString(QString::fromLatin1(v), Qt::RFC2822Date);
+    if (!at.isValid()) return -1;
+    return int(qMax<qint64>(0, now.msecsTo(at)));
+}
+
+// Pauses all polling when the server answers 429/503. Returns true when the
+// reply was rate-limited and the caller should reschedule instead of parsing.
+bool CloudAutoLabeler::handleRateLimit(QNetworkReply *reply, int attempt)
+{
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (httpStatus != 429 && httpStatus != 503) return false;
+
+    int waitMs = parseRetryAfter(reply->rawHeader("Retry-After"),
+                                 QDateTime::currentDateTimeUtc());
+    if (waitMs < 0) waitMs = nextPollDelay(attempt);
+    m_pollPausedUntil = qMax(m_pollPausedUntil, m_clock.elapsed() + waitMs);
+    return true;
+}
+
+// Arms the poll timer for the earliest pending poll deadline, or stops it
+// when nothing is due. While MAX_CONCURRENT_POLLS requests are in flight the
+// timer stays idle; the next reply calls back in here.
+void CloudAutoLabeler::schedulePoll()
+{
+    qint64 due = -1;
+    if (m_batchMode) {
+        if (m_pollsInFlight < MAX_CONCURRENT_POLLS) {
+            for (const ChunkPtr &chunk : std::as_const(m_activeChunks)) {
+                for (int i = 0; i < chunk->statuses.size(); ++i) {
+                    if (chunk->statuses[i] != 0 || chunk->pollInFlight[i]) continue;
+                    if (due < 0 || chunk->nextPollAt[i] < due)
+                        due = chunk->nextPollAt[i];
+                }
+            }
+        }
+    } else if (m_pendingJobId >= 0 && !m_singlePolling) {
+        due = m_singleNextPollAt;
+    }
+
+    if (due < 0) {
+        m_pollTimer->stop();
+        return;
+    }
+    due = qMax(due, m_pollPausedUntil);
+    m_pollTimer->start(int(qMax<qint64>(0, due - m_clock.elapsed())));
+}
+
+QString CloudAutoLabeler::effectivePrompt() const
+{
+    return m_prompt.isEmpty() ? m_classes.join(" ; ") : m_prompt;
+}
+
+// Validated label text for one server result (or cached copy of one).
+QByteArray CloudAutoLabeler::labelTextFor(const JobResult &result) const
+{
+    if (result.hasClassNames)
+        return remapWithClassNames(result.yoloTxt, result.classNames, m_classes);
+    return filterValidDetections(result.yoloTxt, m_classes.size());
+}
+
+CloudAutoLabeler::JobResult CloudAutoLabeler::jobResultFromCache(const QJsonObject &entry)
+{
+    JobResult result;
+    result.yoloTxt = entry.value("yolo_txt").toString().toUtf8();
+    result.hasClassNames = entry.contains("class_names");
+    for (const QJsonValue &v : entry.value("class_names").toArray())
+        result.classNames.append(v.toString());
+    return result;
+}
+
+QJsonObject CloudAutoLabeler::jobResultToCache(const JobResult &result)
+{
+    QJsonObject entry{ { "yolo_txt", QString::fromUtf8(result.yoloTxt) } };
+    if (result.hasClassNames)
+        entry["class_names"] = QJsonArray::fromStringList(result.classNames);
+    return entry;
+}
+
 QString CloudAutoLabeler::mimeForImage(const QString &path)
 {
     const QString lower = path.toLower();
@@ -132,13 +441,147 @@ QString CloudAutoLabeler::mimeForImage(const QString &path)
     return "image/jpeg";
 }
 
-void CloudAutoLabeler::backupLabelFile(const QString &labelPath)
+// Runs on a worker thread. Downscales images whose long side exceeds
+// maxSide and re-encodes them; returns an entry with empty bytes when the
+// original file is already the better upload (small enough, or smaller than
+// the re-encoded result, or unreadable — the server will report those).
+CloudAutoLabeler::PreparedUpload CloudAutoLabeler::prepareUpload(
+    const QString &path, int maxSide, int quality, const QByteArray &format)
+{
+    TRACE_SCOPE("cloud", "prepareUpload");
+    const QFileInfo info(path);
+    PreparedUpload out;
+    out.modified = info.lastModified();
+    out.fileSize = info.size();
+    out.maxSide  = maxSide;
+    out.quality  = quality;
+    out.format   = format;
+
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    const QSize stored = reader.size();
+    if (!stored.isValid()) return out;
+
+    const bool needsResize = qMax(stored.width(), stored.height()) > maxSide;
+    const QByteArray srcFormat = reader.format();
+    if (!needsResize && (srcFormat == "jpeg" || srcFormat == "jpg" || srcFormat == "webp"))
+        return out;   // re-encoding would only add loss
+
+    // Labels are normalized, so any aspect-preserving size gives the same
+    // coordinates. The target box is square, so EXIF rotation doesn't matter.
+    if (needsResize)
+        reader.setScaledSize(stored.scaled(maxSide, maxSide, Qt::KeepAspectRatio));
+
+    QImage img = reader.read();
+    if (img.isNull()) return out;
+    if (format == "jpg" && img.format() != QImage::Format_RGB888)
+        img = img.convertToFormat(QImage::Format_RGB888);
+
+    QBuffer buf(&out.bytes);
+    buf.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buf, format);
+    writer.setQuality(quality);
+    if (!writer.write(img) || out.bytes.size() >= out.fileSize) {
+        out.bytes.clear();
+        return out;
+    }
+    out.mime     = format == "webp" ? "image/webp" : "image/jpeg";
+    out.fileName = info.completeBaseName() + "." + QString::fromLatin1(format);
+    return out;
+}
+
+// Returns the cached preparation for path if it matches the file on disk and
+// the current settings, or nullptr when it must be (re)prepared.
+const CloudAutoLabeler::PreparedUpload *CloudAutoLabeler::preparedFor(const QString &path)
+{
+    const PreparedUpload *p = m_prepared.object(path);
+    if (!p) return nullptr;
+
+    const QFileInfo info(path);
+    if (p->modified != info.lastModified() || p->fileSize != info.size()
+        || p->maxSide != m_uploadMaxSide || p->quality != m_uploadQuality
+        || p->format != m_uploadFormat) {
+        m_prepared.remove(path);
+        return nullptr;
+    }
+    return p;
+}
+
+// Prepares every path in `paths` that has no valid cached preparation on the
+// global thread pool, then calls `then` on this object's thread. Results
+// from before a cancel are dropped by the generation check.
+void CloudAutoLabeler::prepareUploads(const QStringList &paths, const std::function<void()> &then)
+{
+    QStringList todo;
+    for (const QString &path : paths)
+        if (!preparedFor(path))
+            todo.append(path);
+    if (todo.isEmpty()) {
+        then();
+        return;
+    }
+
+    emit statusMessage(QString("Preparing %1 image(s) for upload\u2026").arg(todo.size()), 2000);
+
+    auto remaining = std::make_shared<int>(todo.size());
+    const int        gen     = m_generation;
+    const int        maxSide = m_uploadMaxSide;
+    const int        quality = m_uploadQuality;
+    const QByteArray format  = m_uploadFormat;
+    QPointer<CloudAutoLabeler> self(this);
+
+    for (const QString &path : std::as_const(todo)) {
+        QThreadPool::globalInstance()->start([self, path, maxSide, quality, format, gen, remaining, then]() {
+            PreparedUpload prepared = prepareUpload(path, maxSide, quality, format);
+            if (!self) return;
+            QMetaObject::invokeMethod(self.data(), [self, path, prepared, gen, remaining, then]() {
+                if (self->m_generation != gen) return;
+
+                // Oversized results fall back to the original rather than
+                // being rejected by the cache, so preparedFor() always hits.
+                auto *entry = new PreparedUpload(prepared);
+                if (entry->bytes.size() >= self->m_prepared.maxCost())
+                    entry->bytes.clear();
+                if (entry->fileSize > 0) {
+                    const qint64 sent  = entry->bytes.isEmpty() ? entry->fileSize : entry->bytes.size();
+                    self->m_prepRatio  = 0.8 * self->m_prepRatio + 0.2 * (double(sent) / entry->fileSize);
+                }
+                self->m_prepared.insert(path, entry, qMax<qsizetype>(1, entry->bytes.size()));
+
+                if (--(*remaining) == 0) then();
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+// Appends one image form field: the prepared bytes when upload preparation
+// produced a smaller file, otherwise the original file streamed from disk.
+bool CloudAutoLabeler::appendImagePart(QHttpMultiPart *multiPart, const QString &fieldName,
+                                       const QString &imagePath)
 {
-    if (QFile::exists(labelPath)) {
-        const QString bak = labelPath + ".bak";
-        QFile::remove(bak);
-        QFile::copy(labelPath, bak);
+    const PreparedUpload *prepared = m_uploadMaxSide > 0 ? preparedFor(imagePath) : nullptr;
+
+    QHttpPart imgPart;
+    if (prepared && !prepared->bytes.isEmpty()) {
+        imgPart.setHeader(QNetworkRequest::ContentTypeHeader, QString::fromLatin1(prepared->mime));
+        imgPart.setHeader(QNetworkRequest::ContentDispositionHeader,
+            QString("form-data; name=\"%1\"; filename=\"%2\"")
+                .arg(fieldName, prepared->fileName));
+        imgPart.setBody(prepared->bytes);   // implicitly shared, no copy
+    } else {
+        // Use setBodyDevice() so the file is streamed without an in-memory copy.
+        // QFile is parented to multiPart and deleted automatically with the reply.
+        QFile *imgFile = new QFile(imagePath, multiPart);
+        if (!imgFile->open(QIODevice::ReadOnly))
+            return false;
+        imgPart.setHeader(QNetworkRequest::ContentTypeHeader, mimeForImage(imagePath));
+        imgPart.setHeader(QNetworkRequest::ContentDispositionHeader,
+            QString("form-data; name=\"%1\"; filename=\"%2\"")
+                .arg(fieldName, QFileInfo(imagePath).fileName()));
+        imgPart.setBodyDevice(imgFile);
     }
+    multiPart->append(imgPart);
+    return true;
 }
 
 QString CloudAutoLabeler::labelPathFor(const QString &imagePath)
@@ -147,88 +590,311 @@ QString CloudAutoLabeler::labelPathFor(const QString &imagePath)
         QFileInfo(imagePath).baseName() + ".txt");
 }
 
-// Validates and filters server-returned YOLO text.
-// Each line must have exactly 5 fields, all numeric, with classId in [0, numClasses)
-// and coordinates/dimensions within [0, 1] range.
-// Returns empty string when numClasses <= 0 (no class file loaded) to prevent
-// writing unvalidatable data to disk.
-QString CloudAutoLabeler::filterValidDetections(const QString &yoloTxt, int numClasses)
+// ── Result parsing ──────────────────────────────────────────────────────────
+// Replies can hold thousands of lines, so they are parsed in place: fields
+// are views into the reply, numbers go through from_chars, and kept lines
+// are copied to the output once.
+
+// One valid line, as offsets into the source text.
+struct ParsedDetection
 {
-    // Reject all results when no class file is loaded — class IDs cannot be validated.
-    if (numClasses <= 0) return QString();
+    int       classId;
+    qsizetype begin;    // trimmed line
+    qsizetype idEnd;    // end of the class ID field
+    qsizetype end;
+};
 
-    QString result;
-    for (const QString &rawLine : yoloTxt.split('\n')) {
-        const QString line = rawLine.trimmed();
-        if (line.isEmpty()) continue;
+static bool isTrimmable(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Accepts an optional leading '+', like QString::toInt()/toDouble().
+static QByteArrayView stripPlus(QByteArrayView field)
+{
+    return (field.size() > 1 && field.front() == '+' && field[1] != '-')
+           ? field.sliced(1) : field;
+}
 
-        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-        if (parts.size() != 5) continue; // reject malformed lines
+static bool parseInt(QByteArrayView field, int &out)
+{
+    field = stripPlus(field);
+    const char *end = field.data() + field.size();
+    const auto [ptr, ec] = std::from_chars(field.data(), end, out);
+    return !field.isEmpty() && ec == std::errc() && ptr == end;
+}
 
-        bool okId, okCx, okCy, okW, okH;
-        const int    classId = parts[0].toInt(&okId);
-        const double cx      = parts[1].toDouble(&okCx);
-        const double cy      = parts[2].toDouble(&okCy);
-        const double w       = parts[3].toDouble(&okW);
-        const double h       = parts[4].toDouble(&okH);
+static bool parseDouble(QByteArrayView field, double &out)
+{
+#if defined(__cpp_lib_to_chars)
+    field = stripPlus(field);
+    const char *end = field.data() + field.size();
+    const auto [ptr, ec] = std::from_chars(field.data(), end, out);
+    if (field.isEmpty() || ec != std::errc() || ptr != end) return false;
+#else
+    // Standard library without floating-point from_chars
+    bool ok = false;
+    out = field.toDouble(&ok);
+    if (!ok) return false;
+#endif
+    return std::isfinite(out);
+}
 
-        if (!okId || !okCx || !okCy || !okW || !okH) continue; // non-numeric fields
-        if (classId < 0 || classId >= numClasses)    continue; // class ID out of range
+// Returns the lines with five numeric fields and in-range coordinates.
+// Class IDs are left to the caller.
+static QVector<ParsedDetection> parseDetections(QByteArrayView text)
+{
+    QVector<ParsedDetection> out;
+    const char     *data = text.data();
+    const qsizetype size = text.size();
+
+    for (qsizetype pos = 0; pos < size;) {
+        qsizetype eol = text.indexOf('\n', pos);
+        if (eol < 0) eol = size;
+        qsizetype b = pos, e = eol;
+        pos = eol + 1;
+
+        while (b < e && isTrimmable(data[b]))     ++b;
+        while (e > b && isTrimmable(data[e - 1])) --e;
+        if (b == e) continue;
+
+        QByteArrayView fields[5];
+        int nFields = 0;
+        for (qsizetype i = b; i < e && nFields <= 5;) {
+            while (i < e && data[i] == ' ') ++i;
+            if (i == e) break;
+            qsizetype j = i;
+            while (j < e && data[j] != ' ') ++j;
+            if (nFields < 5) fields[nFields] = QByteArrayView(data + i, j - i);
+            ++nFields;
+            i = j;
+        }
+        if (nFields != 5) continue; // reject malformed lines
+
+        int classId;
+        double cx, cy, w, h;
+        if (!parseInt(fields[0], classId) || !parseDouble(fields[1], cx)
+            || !parseDouble(fields[2], cy) || !parseDouble(fields[3], w)
+            || !parseDouble(fields[4], h))
+            continue;                                               // non-numeric fields
         if (cx < 0.0 || cx > 1.0 || cy < 0.0 || cy > 1.0) continue; // center out of [0,1]
         if (w <= 0.0 || w > 1.0  || h <= 0.0 || h > 1.0)  continue; // size out of (0,1]
 
-        result += line + '\n';
+        out.append({ classId, b, b + fields[0].size(), e });
+    }
+    return out;
+}
+
+// Returns empty when numClasses <= 0 (no class file loaded) to prevent
+// writing unvalidatable data to disk.
+QByteArray CloudAutoLabeler::filterValidDetections(QByteArrayView yoloTxt, int numClasses)
+{
+    if (numClasses <= 0) return QByteArray();
+
+    QByteArray result;
+    result.reserve(yoloTxt.size());
+    for (const ParsedDetection &d : parseDetections(yoloTxt)) {
+        if (d.classId < 0 || d.classId >= numClasses) continue; // class ID out of range
+        result.append(yoloTxt.sliced(d.begin, d.end - d.begin));
+        result.append('\n');
     }
     return result;
 }
 
-// Remaps yolo_txt using the server-provided class_names list (Option B).
-// serverClassNames[i] is the class name the server assigned to ID i.
-// Matches by name against the local class list and rewrites each line with
-// the local class ID. Lines whose server class is not in the local file are
-// dropped. Coordinate validation is preserved.
-QString CloudAutoLabeler::remapWithClassNames(
-    const QString &yoloTxt,
+QByteArray CloudAutoLabeler::remapWithClassNames(
+    QByteArrayView yoloTxt,
     const QStringList &serverClassNames,
     const QStringList &localClasses)
 {
-    if (localClasses.isEmpty()) return QString();
+    if (localClasses.isEmpty()) return QByteArray();
 
-    // Build a lowercase → local-ID lookup for case-insensitive matching.
-    // Server may return "Person" when the class file has "person" — treat as equal.
+    // Server ID -> local ID (-1 = no match), matched case-insensitively:
+    // the server may return "Person" when the class file has "person".
     QHash<QString, int> nameToLocalId;
     for (int j = 0; j < localClasses.size(); ++j)
         nameToLocalId[localClasses[j].trimmed().toLower()] = j;
-
-    QHash<int, int> remap;
+    QVector<int> remap(serverClassNames.size());
     for (int serverId = 0; serverId < serverClassNames.size(); ++serverId)
         remap[serverId] = nameToLocalId.value(serverClassNames[serverId].trimmed().toLower(), -1);
 
-    QString result;
-    for (const QString &rawLine : yoloTxt.split('\n')) {
-        const QString line = rawLine.trimmed();
-        if (line.isEmpty()) continue;
+    QByteArray result;
+    result.reserve(yoloTxt.size());
+    char idBuf[16];
+    for (const ParsedDetection &d : parseDetections(yoloTxt)) {
+        const int localId = (d.classId >= 0 && d.classId < remap.size()) ? remap[d.classId] : -1;
+        if (localId == -1) continue;
 
-        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-        if (parts.size() != 5) continue;
+        const auto [idEnd, ec] = std::to_chars(idBuf, idBuf + sizeof(idBuf), localId);
+        result.append(idBuf, idEnd - idBuf);
+        result.append(yoloTxt.sliced(d.idEnd, d.end - d.idEnd));
+        result.append('\n');
+    }
+    return result;
+}
 
-        bool okId, okCx, okCy, okW, okH;
-        const int    serverId = parts[0].toInt(&okId);
-        const double cx       = parts[1].toDouble(&okCx);
-        const double cy       = parts[2].toDouble(&okCy);
-        const double w        = parts[3].toDouble(&okW);
-        const double h        = parts[4].toDouble(&okH);
+// Reply scanning for parseJobResult(). Only the top-level object is walked;
+// nested values are skipped by bracket matching, not validated.
 
-        if (!okId || !okCx || !okCy || !okW || !okH)        continue;
-        if (cx < 0.0 || cx > 1.0 || cy < 0.0 || cy > 1.0)  continue;
-        if (w <= 0.0 || w > 1.0  || h <= 0.0 || h > 1.0)   continue;
+static qsizetype skipJsonSpace(QByteArrayView json, qsizetype i)
+{
+    while (i < json.size() && (json[i] == ' ' || json[i] == '\n' || json[i] == '\r' || json[i] == '\t'))
+        ++i;
+    return i;
+}
 
-        const int localId = remap.value(serverId, -1);
-        if (localId == -1) continue;
+// i is at the opening quote; returns the index past the closing one, or -1.
+static qsizetype skipJsonString(QByteArrayView json, qsizetype i)
+{
+    for (++i; i < json.size(); ++i) {
+        if (json[i] == '\\')     ++i;
+        else if (json[i] == '"') return i + 1;
+    }
+    return -1;
+}
 
-        result += QString::number(localId) + line.mid(line.indexOf(' ')) + '\n';
+// Returns the index past the value starting at i, or -1.
+static qsizetype skipJsonValue(QByteArrayView json, qsizetype i)
+{
+    if (i >= json.size()) return -1;
+    if (json[i] == '"') return skipJsonString(json, i);
+    if (json[i] == '{' || json[i] == '[') {
+        int depth = 0;
+        while (i < json.size()) {
+            const char c = json[i];
+            if (c == '"') {
+                i = skipJsonString(json, i);
+                if (i < 0) return -1;
+                continue;
+            }
+            if (c == '{' || c == '[') ++depth;
+            else if ((c == '}' || c == ']') && --depth == 0) return i + 1;
+            ++i;
+        }
+        return -1;
     }
-    return result;
+    const qsizetype start = i;                    // number, true, false, null
+    while (i < json.size() && json[i] != ',' && json[i] != '}' && json[i] != ']'
+           && json[i] != ' ' && json[i] != '\n' && json[i] != '\r' && json[i] != '\t')
+        ++i;
+    return i > start ? i : -1;
+}
+
+static void appendUtf8(QByteArray &out, char32_t cp)
+{
+    if (cp < 0x80) {
+        out.append(char(cp));
+    } else if (cp < 0x800) {
+        out.append(char(0xC0 | (cp >> 6)));
+        out.append(char(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.append(char(0xE0 | (cp >> 12)));
+        out.append(char(0x80 | ((cp >> 6) & 0x3F)));
+        out.append(char(0x80 | (cp & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (cp >> 18)));
+        out.append(char(0x80 | ((cp >> 12) & 0x3F)));
+        out.append(char(0x80 | ((cp >> 6) & 0x3F)));
+        out.append(char(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool parseHex4(QByteArrayView s, qsizetype i, char16_t &out)
+{
+    if (i + 4 > s.size()) return false;
+    bool ok = false;
+    out = char16_t(s.sliced(i, 4).toUShort(&ok, 16));
+    return ok;
+}
+
+// Decodes the contents of a JSON string (between the quotes) to UTF-8.
+// Runs without escapes are copied in one piece.
+static bool unescapeJsonString(QByteArrayView s, QByteArray &out)
+{
+    out.clear();
+    out.reserve(s.size());
+    for (qsizetype i = 0; i < s.size();) {
+        qsizetype bs = s.indexOf('\\', i);
+        if (bs < 0) bs = s.size();
+        out.append(s.sliced(i, bs - i));
+        if (bs == s.size()) break;
+        if (bs + 1 == s.size()) return false;
+
+        i = bs + 2;
+        switch (s[bs + 1]) {
+        case '"':  out.append('"');  break;
+        case '\\': out.append('\\'); break;
+        case '/':  out.append('/');  break;
+        case 'b':  out.append('\b'); break;
+        case 'f':  out.append('\f'); break;
+        case 'n':  out.append('\n'); break;
+        case 'r':  out.append('\r'); break;
+        case 't':  out.append('\t'); break;
+        case 'u': {
+            char16_t hi;
+            if (!parseHex4(s, i, hi)) return false;
+            i += 4;
+            char32_t cp = hi;
+            if (QChar::isHighSurrogate(hi)) {
+                char16_t lo;
+                if (i + 6 <= s.size() && s[i] == '\\' && s[i + 1] == 'u'
+                    && parseHex4(s, i + 2, lo) && QChar::isLowSurrogate(lo)) {
+                    cp = QChar::surrogateToUcs4(hi, lo);
+                    i += 6;
+                } else {
+                    cp = QChar::ReplacementCharacter;
+                }
+            } else if (QChar::isLowSurrogate(hi)) {
+                cp = QChar::ReplacementCharacter;
+            }
+            appendUtf8(out, cp);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CloudAutoLabeler::parseJobResult(QByteArrayView json, JobResult &out)
+{
+    out = JobResult();
+    qsizetype i = skipJsonSpace(json, 0);
+    if (i >= json.size() || json[i] != '{') return false;
+    i = skipJsonSpace(json, i + 1);
+    if (i < json.size() && json[i] == '}') return true;
+
+    while (i < json.size() && json[i] == '"') {
+        const qsizetype keyEnd = skipJsonString(json, i);
+        if (keyEnd < 0) return false;
+        const QByteArrayView key = json.sliced(i + 1, keyEnd - i - 2);
+        i = skipJsonSpace(json, keyEnd);
+        if (i >= json.size() || json[i] != ':') return false;
+
+        const qsizetype valueBegin = skipJsonSpace(json, i + 1);
+        const qsizetype valueEnd   = skipJsonValue(json, valueBegin);
+        if (valueEnd < 0) return false;
+        const QByteArrayView value = json.sliced(valueBegin, valueEnd - valueBegin);
+
+        // Non-string yolo_txt (e.g. null) reads as empty, as QJsonValue::toString() would
+        if (key == "yolo_txt" && value.front() == '"') {
+            if (!unescapeJsonString(value.sliced(1, value.size() - 2), out.yoloTxt))
+                return false;
+        } else if (key == "class_names") {
+            out.hasClassNames = true;
+            out.classNames.clear();
+            for (const QJsonValue &v : QJsonDocument::fromJson(value.toByteArray()).array())
+                out.classNames.append(v.toString());
+        } else if (key == "compute_ms") {
+            out.computeMs = value.toInt();
+        }
+
+        i = skipJsonSpace(json, valueEnd);
+        if (i < json.size() && json[i] == '}') return true;
+        if (i >= json.size() || json[i] != ',') return false;
+        i = skipJsonSpace(json, i + 1);
+    }
+    return false;
 }
 
 // ── Single-image flow ───────────────────────────────────────────────────────
@@ -253,7 +919,25 @@ void CloudAutoLabeler::submitSingle(const QString &imagePath, int retryCount)
 {
     m_pendingPath  = imagePath;
 
-    QString effectivePrompt = m_prompt.isEmpty() ? m_classes.join(" ; ") : m_prompt;
+    // One file hashes in a few ms, so the single-image path checks inline
+    if (m_resultCache.isEnabled() && !m_resultKeys.contains(imagePath)) {
+        const QByteArray key = CloudResultCache::key(
+            CloudResultCache::contentHash(imagePath), effectivePrompt(), m_classes);
+        m_resultKeys.insert(imagePath, key);
+
+        QJsonObject cached;
+        if (m_resultCache.lookup(key, cached)) {
+            writeSingleLabel(jobResultFromCache(cached));
+            return;
+        }
+    }
+
+    if (m_uploadMaxSide > 0 && !preparedFor(imagePath)) {
+        prepareUploads({ imagePath }, [this, imagePath, retryCount]() {
+            submitSingle(imagePath, retryCount);
+        });
+        return;
+    }
 
     QJsonArray classesArr;
     for (const QString &c : m_classes)
@@ -261,26 +945,15 @@ void CloudAutoLabeler::submitSingle(const QString &imagePath, int retryCount)
 
     auto *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
 
-    // Use setBodyDevice() so the file is streamed directly without a redundant in-memory copy.
-    // QFile is parented to multiPart and will be deleted when the reply is deleted.
-    QFile *imgFile = new QFile(imagePath, multiPart);
-    if (!imgFile->open(QIODevice::ReadOnly)) {
+    if (!appendImagePart(multiPart, "image", imagePath)) {
         delete multiPart;
         handleFatalError("Cannot read image: " + imagePath);
         return;
     }
 
-    QHttpPart imgPart;
-    imgPart.setHeader(QNetworkRequest::ContentTypeHeader, mimeForImage(imagePath));
-    imgPart.setHeader(QNetworkRequest::ContentDispositionHeader,
-        QString("form-data; name=\"image\"; filename=\"%1\"")
-            .arg(QFileInfo(imagePath).fileName()));
-    imgPart.setBodyDevice(imgFile);
-    multiPart->append(imgPart);
-
     QHttpPart promptPart;
     promptPart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"prompt\"");
-    promptPart.setBody(effectivePrompt.toUtf8());
+    promptPart.setBody(effectivePrompt().toUtf8());
     multiPart->append(promptPart);
 
     QHttpPart classesPart;
@@ -292,6 +965,7 @@ void CloudAutoLabeler::submitSingle(const QString &imagePath, int retryCount)
     req.setTransferTimeout(30000);
 
     QNetworkReply *reply = m_net->post(req, multiPart);
+    TRACE_REQUEST("cloud", "POST /v1/jobs", reply);
     multiPart->setParent(reply);
 
     const int gen = m_generation;
@@ -316,9 +990,11 @@ void CloudAutoLabeler::submitSingle(const QString &imagePath, int retryCount)
             handleFatalError("Unexpected server response.");
             return;
         }
-        m_pendingJobId = doc.object()["job_id"].toVariant().toLongLong();
-        m_pollCount    = 0;
-        m_pollTimer->start();
+        m_pendingJobId     = doc.object()["job_id"].toVariant().toLongLong();
+        m_pollCount        = 0;
+        m_singleSubmittedAt = m_clock.elapsed();
+        m_singleNextPollAt  = m_singleSubmittedAt + nextPollDelay(0);
+        schedulePoll();
     });
 }
 
@@ -327,7 +1003,7 @@ void CloudAutoLabeler::pollSingle()
     if (m_cancelRequested) return;
     if (m_singlePolling) return;  // previous poll reply still in-flight
 
-    if (++m_pollCount > MAX_POLLS) {
+    if (m_clock.elapsed() - m_singleSubmittedAt > POLL_TIMEOUT_MS) {
         handleFatalError("Job timed out. Please try again.");
         return;
     }
@@ -339,15 +1015,22 @@ void CloudAutoLabeler::pollSingle()
     m_singlePolling = true;
     const int gen = m_generation;
     QNetworkReply *reply = m_net->get(req);
+    TRACE_REQUEST("cloud", "GET /v1/jobs/{id}", reply);
     connect(reply, &QNetworkReply::finished, this, [this, reply, gen]() {
         reply->deleteLater();
         m_singlePolling = false;
         if (m_generation != gen) return;
 
-        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-        if (doc.isNull() || !doc.isObject()) return; // keep polling
+        ++m_pollCount;
+        if (handleRateLimit(reply, m_pollCount)) {
+            m_singleNextPollAt = m_pollPausedUntil;
+            schedulePoll();
+            return;
+        }
 
-        const QString status = doc.object()["status"].toString();
+        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+        const QString status = (!doc.isNull() && doc.isObject())
+                               ? doc.object()["status"].toString() : QString();
         if (status == "succeeded") {
             m_pollTimer->stop();
             m_pollCount = 0;
@@ -355,8 +1038,11 @@ void CloudAutoLabeler::pollSingle()
         } else if (status == "failed") {
             handleFatalError("Job failed: " +
                 doc.object().value("error_message").toString());
+        } else {
+            // queued / running / unparsable → keep polling, backing off
+            m_singleNextPollAt = m_clock.elapsed() + nextPollDelay(m_pollCount);
+            schedulePoll();
         }
-        // queued / running → keep polling
     });
 }
 
@@ -368,6 +1054,7 @@ void CloudAutoLabeler::fetchSingleResult(int retryCount)
 
     const int gen = m_generation;
     QNetworkReply *reply = m_net->get(req);
+    TRACE_REQUEST("cloud", "GET /v1/jobs/{id}/result", reply);
     connect(reply, &QNetworkReply::finished, this, [this, reply, gen, retryCount]() {
         reply->deleteLater();
         if (m_generation != gen) return;
@@ -384,81 +1071,158 @@ void CloudAutoLabeler::fetchSingleResult(int retryCount)
             return;
         }
 
-        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-        if (doc.isNull() || !doc.isObject()) {
+        JobResult result;
+        if (!parseJobResult(reply->readAll(), result)) {
             handleFatalError("Failed to parse job result.");
             return;
         }
 
-        const QJsonObject result = doc.object();
-        const QString     raw    = result.value("yolo_txt").toString();
-        QString yoloTxt;
-        if (result.contains("class_names")) {
-            QStringList serverNames;
-            for (const QJsonValue &v : result.value("class_names").toArray())
-                serverNames.append(v.toString());
-            yoloTxt = remapWithClassNames(raw, serverNames, m_classes);
-        } else {
-            yoloTxt = filterValidDetections(raw, m_classes.size());
-        }
-        const int         n       = yoloTxt.isEmpty() ? 0
-                                    : yoloTxt.trimmed().count('\n') + 1;
-        const int         ms      = result.value("compute_ms").toInt();
-
-        const QString lp = labelPathFor(m_pendingPath);
-        backupLabelFile(lp);
-        QFile lf(lp);
-        if (!lf.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            emit statusMessage(
-                QString("Cloud auto-label: write failed for %1").arg(lp), 5000);
-            processNextInQueue();
-            return;
-        }
-        lf.write(yoloTxt.toUtf8());
-        lf.close();
+        if (m_resultCache.isEnabled())
+            m_resultCache.store(m_resultKeys.value(m_pendingPath), jobResultToCache(result));
+        writeSingleLabel(result);
+    });
+}
 
-        ++m_singleWriteOk;
-        emit statusMessage(
-            QString("Cloud auto-label: %1 detection(s) in %2 ms").arg(n).arg(ms), 4000);
-        emit labelReady(m_pendingPath, n, ms);
+void CloudAutoLabeler::writeSingleLabel(const JobResult &result)
+{
+    TRACE_SCOPE("cloud", "writeSingleLabel");
+    const QByteArray yoloTxt = labelTextFor(result);
+    const int        n       = yoloTxt.count('\n');   // one line per detection
+    const int        ms      = result.computeMs;
 
+    if (m_userLabeled.contains(m_pendingPath)) {
+        emit statusMessage("Cloud auto-label: kept your edits to this image.", 4000);
         processNextInQueue();
-    });
+        return;
+    }
+
+    const QString lp = labelPathFor(m_pendingPath);
+    m_snapshots.snapshot(lp, yoloTxt);
+    QFile lf(lp);
+    if (!lf.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        emit statusMessage(
+            QString("Cloud auto-label: write failed for %1").arg(lp), 5000);
+        processNextInQueue();
+        return;
+    }
+    lf.write(yoloTxt);
+    lf.close();
+
+    ++m_singleWriteOk;
+    emit statusMessage(
+        QString("Cloud auto-label: %1 detection(s) in %2 ms").arg(n).arg(ms), 4000);
+    emit labelReady(m_pendingPath, n, ms);
+
+    processNextInQueue();
 }
 
 // ── Batch flow ──────────────────────────────────────────────────────────────
 
-void CloudAutoLabeler::submitBatchChunk(const QStringList &imagePaths, int retryCount)
+// Keeps up to m_maxChunksInFlight chunks active. Only one chunk uploads at a
+// time so uploads do not compete for bandwidth; the next one starts as soon
+// as the previous upload is accepted, while earlier chunks are still polled.
+// Chunks resumed from the journal need no upload and take free slots first.
+void CloudAutoLabeler::fillBatchWindow()
+{
+    if (!m_resumedChunks.isEmpty()) {
+        while (!m_resumedChunks.isEmpty() && m_activeChunks.size() < m_maxChunksInFlight) {
+            const ChunkPtr chunk = m_resumedChunks.takeFirst();
+            startPollingChunk(chunk);
+            m_activeChunks.append(chunk);
+        }
+        schedulePoll();
+    }
+    if (m_batchUploading) return;
+
+    if (!m_batchPending.isEmpty() && m_activeChunks.size() < m_maxChunksInFlight) {
+        auto chunk   = std::make_shared<BatchChunk>();
+        chunk->paths = takeNextChunk();
+        m_activeChunks.append(chunk);
+        submitBatchChunk(chunk);
+        return;
+    }
+
+    if (m_activeChunks.isEmpty() && m_batchPending.isEmpty() && m_resumedChunks.isEmpty()
+        && !m_batchHashing)
+        finishBatch();
+}
+
+// Bytes an image is expected to add to an upload: the prepared size when
+// known, otherwise the file size scaled by the observed preparation ratio.
+qint64 CloudAutoLabeler::estimatedUploadBytes(const QString &path)
 {
-    m_batchPaths = imagePaths;
-    m_batchJobIds.clear();
+    const qint64 fileSize = QFileInfo(path).size();
+    if (m_uploadMaxSide <= 0) return fileSize;
+
+    if (const PreparedUpload *p = preparedFor(path))
+        return p->bytes.isEmpty() ? p->fileSize : p->bytes.size();
+    return qint64(fileSize * m_prepRatio);
+}
+
+// Takes the next chunk off m_batchPending, sized so that it uploads in about
+// TARGET_CHUNK_SECONDS at the measured throughput, capped at BATCH_SIZE
+// images. Prioritized images go up in a chunk of their own.
+QStringList CloudAutoLabeler::takeNextChunk()
+{
+    const qint64 budget = qBound(MIN_CHUNK_BYTES,
+                                 qint64(m_uploadBytesPerSec * TARGET_CHUNK_SECONDS),
+                                 MAX_CHUNK_BYTES);
+    const bool priority = m_priorityPaths.contains(m_batchPending.first());
+
+    QStringList chunk;
+    qint64      bytes = 0;
+    while (!m_batchPending.isEmpty() && chunk.size() < BATCH_SIZE) {
+        const QString &next = m_batchPending.first();
+        if (m_priorityPaths.contains(next) != priority) break;
+
+        const qint64 size = estimatedUploadBytes(next);
+        if (!chunk.isEmpty() && bytes + size > budget) break;
+        bytes += size;
+        chunk.append(m_batchPending.takeFirst());
+    }
+    return chunk;
+}
+
+// Folds one measured upload into the throughput estimate.
+void CloudAutoLabeler::recordUploadThroughput(qint64 bytes, qint64 ms)
+{
+    if (bytes <= 0 || ms <= 0) return;
+    const double measured = bytes * 1000.0 / ms;
+    m_uploadBytesPerSec = (1.0 - THROUGHPUT_SMOOTHING) * m_uploadBytesPerSec
+                          + THROUGHPUT_SMOOTHING * measured;
+}
+
+void CloudAutoLabeler::submitBatchChunk(const ChunkPtr &chunk, int retryCount)
+{
+    TRACE_SCOPE("cloud", "submitBatchChunk");
+    m_batchUploading = true;
+    chunk->jobIds.clear();
+
+    // Downscale/re-encode first; this overlaps with earlier chunks' polling
+    if (m_uploadMaxSide > 0) {
+        for (const QString &imagePath : std::as_const(chunk->paths)) {
+            if (!preparedFor(imagePath)) {
+                prepareUploads(chunk->paths, [this, chunk, retryCount]() {
+                    submitBatchChunk(chunk, retryCount);
+                });
+                return;
+            }
+        }
+    }
 
     auto *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
 
-    for (const QString &imagePath : imagePaths) {
-        // Use setBodyDevice() so each file is streamed without an in-memory copy.
-        // QFile is parented to multiPart and deleted automatically with the reply.
-        QFile *imgFile = new QFile(imagePath, multiPart);
-        if (!imgFile->open(QIODevice::ReadOnly)) {
+    for (const QString &imagePath : chunk->paths) {
+        if (!appendImagePart(multiPart, "images", imagePath)) {
             delete multiPart;
             handleFatalError("Cannot read image: " + imagePath);
             return;
         }
-
-        QHttpPart imgPart;
-        imgPart.setHeader(QNetworkRequest::ContentTypeHeader, mimeForImage(imagePath));
-        imgPart.setHeader(QNetworkRequest::ContentDispositionHeader,
-            QString("form-data; name=\"images\"; filename=\"%1\"")
-                .arg(QFileInfo(imagePath).fileName()));
-        imgPart.setBodyDevice(imgFile);
-        multiPart->append(imgPart);
     }
 
-    const QString effectivePrompt = m_prompt.isEmpty() ? m_classes.join(" ; ") : m_prompt;
-
     QHttpPart promptPart;
     promptPart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"prompt\"");
-    promptPart.setBody(effectivePrompt.toUtf8());
+    promptPart.setBody(effectivePrompt().toUtf8());
     multiPart->append(promptPart);
 
     QJsonArray classesArr;
@@ -470,23 +1234,87 @@ void CloudAutoLabeler::submitBatchChunk(const QStringList &imagePaths, int retry
     classesPart.setBody(QJsonDocument(classesArr).toJson(QJsonDocument::Compact));
     multiPart->append(classesPart);
 
+    // Allow several times the expected upload time before giving up, so a
+    // slow link does not turn into a timeout/re-upload loop.
+    qint64 chunkBytes = 0;
+    for (const QString &imagePath : std::as_const(chunk->paths))
+        chunkBytes += estimatedUploadBytes(imagePath);
+    const qint64 expectedMs = qint64(chunkBytes * 1000.0 / m_uploadBytesPerSec);
     QNetworkRequest req = makeRequest("/v1/jobs/batch");
-    req.setTransferTimeout(60000);
+    req.setTransferTimeout(int(qBound<qint64>(60000, 4 * expectedMs, 600000)));
 
     QNetworkReply *reply = m_net->post(req, multiPart);
+    TRACE_REQUEST("cloud", "POST /v1/jobs/batch", reply);
     multiPart->setParent(reply);
 
+    // Measure the upload itself, not the server's response time
+    auto uploadTimer = std::make_shared<QElapsedTimer>();
+    auto uploadMs    = std::make_shared<qint64>(-1);
+    auto uploadBytes = std::make_shared<qint64>(0);
+    uploadTimer->start();
+    connect(reply, &QNetworkReply::uploadProgress, this,
+            [uploadTimer, uploadMs, uploadBytes](qint64 sent, qint64 total) {
+        if (total > 0 && sent == total && *uploadMs < 0) {
+            *uploadMs    = uploadTimer->elapsed();
+            *uploadBytes = total;
+        }
+    });
+
     const int gen = m_generation;
-    connect(reply, &QNetworkReply::finished, this, [this, reply, imagePaths, gen, retryCount]() {
+    connect(reply, &QNetworkReply::finished, this,
+            [this, reply, chunk, gen, retryCount, uploadMs, uploadBytes]() {
         reply->deleteLater();
         if (m_generation != gen) return;
 
+        m_batchUploading = false;
+
         if (reply->error() != QNetworkReply::NoError) {
+            const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            if (httpStatus == 401 || httpStatus == 403) {
+                handleFatalError(
+                    QString("Batch submit rejected (HTTP %1): check your API key.").arg(httpStatus));
+                return;
+            }
+
+            // Rate limited: wait like the pollers do, keeping the upload slot
+            if (handleRateLimit(reply, retryCount + 1)) {
+                m_batchUploading = true;
+                emit statusMessage("Server busy, waiting to resubmit\u2026", 2000);
+                QTimer::singleShot(int(qMax<qint64>(0, m_pollPausedUntil - m_clock.elapsed())), this,
+                                   [this, chunk, retryCount, gen]() {
+                    if (m_generation == gen) submitBatchChunk(chunk, retryCount);
+                });
+                return;
+            }
+
+            const bool timedOut = reply->error() == QNetworkReply::OperationCanceledError
+                               || reply->error() == QNetworkReply::TimeoutError;
+            const bool tooLarge = httpStatus == 413;
+            if (httpStatus >= 400 && httpStatus < 500 && !tooLarge) {
+                handleFatalError(
+                    QString("Batch submit rejected (HTTP %1): %2").arg(httpStatus).arg(reply->errorString()));
+                return;
+            }
+
+            // Split instead of re-sending the whole chunk when its size may
+            // be the cause: the second half goes back to the front of the
+            // queue. Only a slow or oversized upload shrinks later chunks.
+            if ((timedOut || tooLarge || httpStatus >= 500) && chunk->paths.size() > 1) {
+                const int half = chunk->paths.size() / 2;
+                const QStringList rest = chunk->paths.mid(half);
+                chunk->paths = chunk->paths.mid(0, half);
+                m_batchPending = rest + m_batchPending;
+                if (timedOut || tooLarge)
+                    m_uploadBytesPerSec = qMax(MIN_UPLOAD_BPS, m_uploadBytesPerSec / 2);
+                emit statusMessage("Batch submit failed, retrying as smaller chunks\u2026", 2000);
+                submitBatchChunk(chunk, retryCount);
+                return;
+            }
             if (retryCount < MAX_RETRIES) {
                 emit statusMessage(
                     QString("Batch submit failed (%1/%2), retrying\u2026")
                         .arg(retryCount + 1).arg(MAX_RETRIES), 2000);
-                submitBatchChunk(imagePaths, retryCount + 1);
+                submitBatchChunk(chunk, retryCount + 1);
                 return;
             }
             handleFatalError("Batch submit failed: " + reply->errorString());
@@ -499,209 +1327,264 @@ void CloudAutoLabeler::submitBatchChunk(const QStringList &imagePaths, int retry
             return;
         }
         for (const QJsonValue &v : doc.object()["job_ids"].toArray())
-            m_batchJobIds.append(v.toVariant().toLongLong());
+            chunk->jobIds.append(v.toVariant().toLongLong());
 
         // Validate that the server returned exactly one job ID per submitted image
-        if (m_batchJobIds.size() != m_batchPaths.size()) {
+        if (chunk->jobIds.size() != chunk->paths.size()) {
             handleFatalError(
                 QString("Server returned %1 job IDs for %2 images — aborting.")
-                    .arg(m_batchJobIds.size()).arg(m_batchPaths.size()));
+                    .arg(chunk->jobIds.size()).arg(chunk->paths.size()));
             return;
         }
 
-        // Initialize per-job status tracking (0 = pending)
-        m_batchJobStatuses.resize(m_batchJobIds.size());
-        m_batchJobStatuses.fill(0);
+        recordUploadThroughput(*uploadBytes, *uploadMs);
+        m_journal.recordSubmitted(chunk->paths, chunk->jobIds);
+        startPollingChunk(chunk);
 
-        m_pollCount = 0;
-        m_pollTimer->start();
+        // Start uploading the next chunk while this one is processed
+        fillBatchWindow();
+        schedulePoll();
     });
 }
 
-void CloudAutoLabeler::pollBatch()
+// Initializes per-job status tracking (0 = pending) and the poll schedule
+// for a chunk whose job IDs are known.
+void CloudAutoLabeler::startPollingChunk(const ChunkPtr &chunk)
 {
-    if (m_batchPolling) return;
+    const int    n   = chunk->jobIds.size();
+    const qint64 now = m_clock.elapsed();
+    chunk->statuses.fill(0, n);
+    chunk->pollAttempts.fill(0, n);
+    chunk->pollInFlight.fill(false, n);
+    chunk->nextPollAt.resize(n);
+    for (int i = 0; i < n; ++i)
+        chunk->nextPollAt[i] = now + nextPollDelay(0);
+    chunk->submittedAt = now;
+    chunk->unresolved  = n;
+}
 
-    if (++m_pollCount > MAX_POLLS) {
-        const int pending = m_batchJobStatuses.count(0);
-        handleFatalError(
-            QString("Batch jobs timed out: %1/%2 jobs still pending.")
-                .arg(pending).arg(m_batchJobIds.size()));
+// Polls every job whose deadline has passed, most overdue first, up to
+// MAX_CONCURRENT_POLLS requests in flight, then re-arms the timer.
+void CloudAutoLabeler::pollBatch()
+{
+    const qint64 now = m_clock.elapsed();
+    if (now < m_pollPausedUntil) {
+        schedulePoll();
         return;
     }
 
-    // Only poll jobs that are still pending (status 0)
-    QList<int> pendingIdxs;
-    for (int i = 0; i < m_batchJobIds.size(); ++i)
-        if (i < m_batchJobStatuses.size() && m_batchJobStatuses[i] == 0)
-            pendingIdxs.append(i);
-
-    if (pendingIdxs.isEmpty()) return;  // all terminal, timer will be stopped
+    struct DuePoll { qint64 at; ChunkPtr chunk; int idx; };
+    QList<DuePoll> due;
+    const QList<ChunkPtr> chunks = m_activeChunks;  // a fatal error clears the list
+    for (const ChunkPtr &chunk : chunks) {
+        if (!chunk->statuses.contains(0)) continue;  // uploading or fully polled
+        if (now - chunk->submittedAt > POLL_TIMEOUT_MS) {
+            const int pending = chunk->statuses.count(0);
+            handleFatalError(
+                QString("Batch jobs timed out: %1/%2 jobs still pending.")
+                    .arg(pending).arg(chunk->jobIds.size()));
+            return;
+        }
+        for (int i = 0; i < chunk->statuses.size(); ++i) {
+            if (chunk->statuses[i] == 0 && !chunk->pollInFlight[i]
+                && chunk->nextPollAt[i] <= now)
+                due.append({ chunk->nextPollAt[i], chunk, i });
+        }
+    }
+    std::sort(due.begin(), due.end(),
+              [](const DuePoll &a, const DuePoll &b) { return a.at < b.at; });
 
-    // Rate-limit: poll at most MAX_CONCURRENT_POLLS jobs per tick.
-    // Round-robin so that jobs at the back of the list are not starved.
-    if (pendingIdxs.size() > MAX_CONCURRENT_POLLS) {
-        m_pollOffset = m_pollOffset % pendingIdxs.size();
-        QList<int> selected;
-        for (int k = 0; k < MAX_CONCURRENT_POLLS; ++k)
-            selected.append(pendingIdxs[(m_pollOffset + k) % pendingIdxs.size()]);
-        m_pollOffset += MAX_CONCURRENT_POLLS;
-        pendingIdxs = selected;
+    for (const DuePoll &d : std::as_const(due)) {
+        if (m_pollsInFlight >= MAX_CONCURRENT_POLLS) break;
+        pollBatchJob(d.chunk, d.idx);
     }
+    schedulePoll();
+}
 
-    m_batchPolling = true;
-    const int pollCount = pendingIdxs.size();
-    auto remaining = std::make_shared<int>(pollCount);
+void CloudAutoLabeler::pollBatchJob(const ChunkPtr &chunk, int i)
+{
+    const qint64 jobId = chunk->jobIds[i];
+    QNetworkRequest req = makeRequest(QString("/v1/jobs/%1").arg(jobId));
+    req.setTransferTimeout(10000);
 
-    const int gen = m_generation;
-    for (int i : pendingIdxs) {
-        const qint64 jobId = m_batchJobIds[i];
-        QNetworkRequest req = makeRequest(QString("/v1/jobs/%1").arg(jobId));
-        req.setTransferTimeout(10000);
-
-        QNetworkReply *reply = m_net->get(req);
-        connect(reply, &QNetworkReply::finished, this,
-                [this, reply, i, remaining, gen]() {
-            reply->deleteLater();
-            if (m_generation != gen) {
-                if (--(*remaining) == 0) m_batchPolling = false;
-                return;
-            }
+    chunk->pollInFlight[i] = true;
+    ++m_pollsInFlight;
 
-            if (i < m_batchJobStatuses.size()) {
-                QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-                if (!doc.isNull() && doc.isObject()) {
-                    const QString status = doc.object()["status"].toString();
-                    if (status == "succeeded")
-                        m_batchJobStatuses[i] = 1;
-                    else if (status == "failed")
-                        m_batchJobStatuses[i] = 2;
-                }
-            }
+    const int gen = m_generation;
+    QNetworkReply *reply = m_net->get(req);
+    TRACE_REQUEST("cloud", "GET /v1/jobs/{id}", reply);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, chunk, i, gen]() {
+        reply->deleteLater();
+        if (m_generation != gen) return;
 
-            if (--(*remaining) == 0) {
-                m_batchPolling = false;
+        --m_pollsInFlight;
+        chunk->pollInFlight[i] = false;
+        const int attempt = ++chunk->pollAttempts[i];
 
-                // Check whether all jobs have reached a terminal state
-                const bool allTerminal = !m_batchJobStatuses.contains(0);
-                if (!allTerminal) return;  // keep polling
+        if (handleRateLimit(reply, attempt)) {
+            chunk->nextPollAt[i] = m_pollPausedUntil;
+            schedulePoll();
+            return;
+        }
 
-                m_pollTimer->stop();
-                m_pollCount = 0;
+        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+        QString status = (!doc.isNull() && doc.isObject())
+                         ? doc.object()["status"].toString() : QString();
+        // Unknown job, e.g. one from a resumed run that the server expired
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 404)
+            status = "failed";
+        if (status == "succeeded") {
+            // Fetch right away instead of waiting for the rest of the chunk
+            chunk->statuses[i] = 1;
+            enqueueFetch(chunk, i);
+        } else if (status == "failed") {
+            chunk->statuses[i] = 2;
+            ++m_batchFailed;
+            --chunk->unresolved;
+        } else {
+            chunk->nextPollAt[i] = m_clock.elapsed() + nextPollDelay(attempt);
+        }
 
-                const int succeeded = m_batchJobStatuses.count(1);
-                const int failed    = m_batchJobStatuses.count(2);
+        // The reply that settles the last pending job reports on the chunk
+        if (status == "succeeded" || status == "failed") {
+            if (!chunk->statuses.contains(0)) {
+                const int succeeded = chunk->statuses.count(1);
+                const int failed    = chunk->statuses.count(2);
 
+                if (succeeded == 0) {
+                    handleFatalError("All batch jobs in this chunk failed.");
+                    return;
+                }
                 if (failed > 0) {
                     emit statusMessage(
-                        QString("%1/%2 batch jobs failed — fetching %3 result(s).")
-                            .arg(failed).arg(m_batchJobIds.size()).arg(succeeded), 5000);
-                    m_batchFailed += failed;
+                        QString("%1/%2 batch jobs failed.")
+                            .arg(failed).arg(chunk->jobIds.size()), 5000);
                 }
-
-                if (succeeded > 0) {
-                    m_batchChunkWriteSucceeded = 0; // reset before fetch pass for this chunk
-                    fetchBatchResults(0);  // skips failed indices
-                } else {
-                    handleFatalError("All batch jobs in this chunk failed.");
+                // Every result may already have been written while polling
+                if (chunk->unresolved == 0) {
+                    completeBatchChunk(chunk);
+                    return;
                 }
             }
-        });
-    }
+        }
+        schedulePoll();
+    });
 }
 
-void CloudAutoLabeler::fetchBatchResults(int idx, int retryCount)
+void CloudAutoLabeler::enqueueFetch(const ChunkPtr &chunk, int idx)
 {
-    const int gen = m_generation;  // captured for lambdas in this call frame
-
-    if (idx >= m_batchJobIds.size()) {
-        // Chunk complete — count only images where the file was actually written
-        m_batchDone += m_batchChunkWriteSucceeded;
-        m_batchJobIds.clear();
-        m_batchJobStatuses.clear();
-        m_batchPaths.clear();
-        emit progress(m_batchDone, m_batchTotal);
-
-        if (!m_batchChunks.isEmpty()) {
-            submitBatchChunk(m_batchChunks.takeFirst());
-        } else {
-            const int totalFailed = m_batchFailed;
-            emit finished(m_batchDone);
-            if (totalFailed > 0) {
-                emit statusMessage(
-                    QString("Cloud auto-label: %1 done, %2 failed.")
-                        .arg(m_batchDone).arg(totalFailed), 6000);
-            } else {
-                emit statusMessage(
-                    QString("Cloud auto-label: %1 images done.").arg(m_batchDone), 5000);
-            }
-            resetState();
-            setBusy(false);
-        }
-        return;
-    }
+    m_fetchQueue.append(qMakePair(chunk, idx));
+    pumpFetchQueue();
+}
 
-    // Skip jobs that failed on the server — just move to the next
-    if (idx < m_batchJobStatuses.size() && m_batchJobStatuses[idx] == 2) {
-        fetchBatchResults(idx + 1);
-        return;
+// Starts queued result GETs until MAX_CONCURRENT_FETCHES are in flight.
+void CloudAutoLabeler::pumpFetchQueue()
+{
+    while (m_fetchesInFlight < MAX_CONCURRENT_FETCHES && !m_fetchQueue.isEmpty()) {
+        const QPair<ChunkPtr, int> next = m_fetchQueue.takeFirst();
+        ++m_fetchesInFlight;
+        fetchBatchResult(next.first, next.second);
     }
+}
 
-    const qint64  jobId     = m_batchJobIds[idx];
-    const QString imagePath = m_batchPaths[idx];
+void CloudAutoLabeler::fetchBatchResult(const ChunkPtr &chunk, int idx, int retryCount)
+{
+    const qint64  jobId     = chunk->jobIds[idx];
+    const QString imagePath = chunk->paths[idx];
 
     QNetworkRequest req = makeRequest(QString("/v1/jobs/%1/result").arg(jobId));
     req.setTransferTimeout(15000);
 
+    const int gen = m_generation;
     QNetworkReply *reply = m_net->get(req);
-    connect(reply, &QNetworkReply::finished, this, [this, reply, imagePath, idx, gen, retryCount]() {
+    TRACE_REQUEST("cloud", "GET /v1/jobs/{id}/result", reply);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, chunk, imagePath, idx, gen, retryCount]() {
         reply->deleteLater();
         if (m_generation != gen) return;
 
         if (reply->error() != QNetworkReply::NoError) {
             if (retryCount < MAX_RETRIES) {
-                fetchBatchResults(idx, retryCount + 1);
+                fetchBatchResult(chunk, idx, retryCount + 1);  // keeps its slot
                 return;
             }
-            // Fetch failed after retries — count as failure, move to next image
+            // Fetch failed after retries — count as failure
             ++m_batchFailed;
-            fetchBatchResults(idx + 1);
+            finishFetch(chunk);
             return;
         }
 
-        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-        if (!doc.isNull() && doc.isObject()) {
-            const QJsonObject obj = doc.object();
-            const QString     raw = obj.value("yolo_txt").toString();
-            QString yoloTxt;
-            if (obj.contains("class_names")) {
-                QStringList serverNames;
-                for (const QJsonValue &v : obj.value("class_names").toArray())
-                    serverNames.append(v.toString());
-                yoloTxt = remapWithClassNames(raw, serverNames, m_classes);
-            } else {
-                yoloTxt = filterValidDetections(raw, m_classes.size());
-            }
-            const QString lp      = labelPathFor(imagePath);
-            backupLabelFile(lp);
-            QFile lf(lp);
-            if (!lf.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                // File write failed — count as failure, do not emit labelReady
-                ++m_batchFailed;
-                fetchBatchResults(idx + 1);
-                return;
-            }
-            lf.write(yoloTxt.toUtf8());
-            lf.close();
-
-            ++m_batchChunkWriteSucceeded;
-            const int n = yoloTxt.isEmpty() ? 0
-                          : yoloTxt.trimmed().count('\n') + 1;
-            emit labelReady(imagePath, n, 0);
+        JobResult result;
+        if (parseJobResult(reply->readAll(), result)) {
+            if (m_resultCache.isEnabled())
+                m_resultCache.store(m_resultKeys.value(imagePath), jobResultToCache(result));
+            writeBatchLabel(imagePath, result);
         } else {
-            // JSON parse failure — count as failure, move to next image
+            // JSON parse failure — count as failure
             ++m_batchFailed;
         }
-        fetchBatchResults(idx + 1);
+        finishFetch(chunk);
     });
 }
+
+void CloudAutoLabeler::writeBatchLabel(const QString &imagePath, const JobResult &result)
+{
+    TRACE_SCOPE("cloud", "writeBatchLabel");
+    if (m_userLabeled.contains(imagePath)) {
+        // Counted as done so the run completes and a resume skips it
+        m_journal.recordDone(imagePath);
+        ++m_batchDone;
+        emit progress(m_batchDone, m_batchTotal);
+        return;
+    }
+
+    const QByteArray yoloTxt = labelTextFor(result);
+    const QString    lp      = labelPathFor(imagePath);
+    m_snapshots.snapshot(lp, yoloTxt);
+    QFile lf(lp);
+    if (!lf.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        // File write failed — count as failure, do not emit labelReady
+        ++m_batchFailed;
+        return;
+    }
+    lf.write(yoloTxt);
+    lf.close();
+
+    m_journal.recordDone(imagePath);
+    ++m_batchDone;
+    emit progress(m_batchDone, m_batchTotal);
+    const int n = yoloTxt.count('\n');
+    emit labelReady(imagePath, n, 0);
+}
+
+void CloudAutoLabeler::finishFetch(const ChunkPtr &chunk)
+{
+    --m_fetchesInFlight;
+    if (--chunk->unresolved == 0)
+        completeBatchChunk(chunk);
+    pumpFetchQueue();
+}
+
+void CloudAutoLabeler::completeBatchChunk(const ChunkPtr &chunk)
+{
+    m_activeChunks.removeOne(chunk);
+    fillBatchWindow();
+}
+
+void CloudAutoLabeler::finishBatch()
+{
+    m_pollTimer->stop();
+    m_journal.finish();
+
+    const int totalFailed = m_batchFailed;
+    emit finished(m_batchDone);
+    if (totalFailed > 0) {
+        emit statusMessage(
+            QString("Cloud auto-label: %1 done, %2 failed.")
+                .arg(m_batchDone).arg(totalFailed), 6000);
+    } else {
+        emit statusMessage(
+            QString("Cloud auto-label: %1 images done.").arg(m_batchDone), 5000);
+    }
+    resetState();
+    setBusy(false);
+}
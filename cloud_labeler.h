@@ -2,6 +2,9 @@
 #define CLOUD_LABELER_H
 
 #include <QObject>
+#include <QByteArrayView>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QStringList>
 #include <QTimer>
 #include <QNetworkAccessManager>
@@ -11,8 +14,16 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <functional>
 #include <memory>
 
+#include "cloud_batch_journal.h"
+#include "cloud_result_cache.h"
+#include "label_snapshot_store.h"
+
 // CloudAutoLabeler encapsulates all network communication with the
 // yololabel.com cloud inference API. It mirrors the YoloDetector pattern:
 // MainWindow holds an instance, calls its public methods, and reacts to
@@ -29,6 +40,45 @@ public:
     void setPrompt(const QString &prompt);
     void setClasses(const QStringList &classes);
 
+    // Base URL of the cloud API, API_HOST by default. Tests and the load
+    // benchmark point it at a local mock server.
+    void setApiHost(const QString &host);
+
+    // Number of batch chunks kept active at once (uploading, polling or
+    // fetching). 1 restores strictly sequential chunk processing.
+    void setMaxChunksInFlight(int n);
+
+    // Directory of the on-disk result cache; results for an unchanged image
+    // with the same prompt and classes are reused without any network
+    // traffic. Defaults to CloudResultCache::defaultDirectory(); empty
+    // disables the cache.
+    void setResultCacheDirectory(const QString &dir);
+
+    // Journal file that lets an interrupted batch be resumed after a crash
+    // or restart. Defaults to CloudBatchJournal::defaultPath(); empty
+    // disables journaling.
+    void setJournalPath(const QString &path);
+
+    // Directory of the label snapshot packs: each run records the previous
+    // contents of the labels it overwrites so the run can be undone.
+    // Defaults to LabelSnapshotStore::defaultDirectory(); empty disables it.
+    void setSnapshotDirectory(const QString &dir);
+    QList<LabelSnapshotStore::RunInfo> snapshotRuns() const { return m_snapshots.runs(); }
+    // Opens the snapshot run of the next labelImages() call early, so labels
+    // written before it (local-first routing) join the same run. Call
+    // endSnapshotRun() instead if no cloud job follows.
+    void beginSnapshotRun();
+    void endSnapshotRun();
+    // Records labelPath in the open run before newContents is written to it.
+    void snapshotLabel(const QString &labelPath, const QByteArray &newContents);
+
+    // Optional upload preparation: images whose long side exceeds maxSide
+    // are downscaled and re-encoded ("jpg" or "webp") on the global thread
+    // pool before upload, and the bytes are cached per image. Labels are
+    // normalized, so the result is unchanged. maxSide 0 uploads originals.
+    void setUploadPreparation(int maxSide, int quality = DEFAULT_UPLOAD_QUALITY,
+                              const QString &format = QStringLiteral("jpg"));
+
     QString apiKey()  const { return m_apiKey; }
     QString prompt()  const { return m_prompt; }
     bool    isBusy()  const { return m_busy; }
@@ -38,6 +88,45 @@ public:
     void labelImages(const QStringList &imagePaths);    // batch (all images)
     void cancel();
 
+    // Priority lane: moves these images (e.g. the one on screen and the next
+    // few) ahead of the rest of a running batch so they are labeled first.
+    void prioritize(const QStringList &imagePaths);
+    // The user saved this image's label by hand during the run; its cloud
+    // result is dropped instead of overwriting that label.
+    void keepUserLabel(const QString &imagePath);
+
+    // Interrupted batch left in the journal (invalid State if none).
+    CloudBatchJournal::State resumableBatch() const;
+    // Restores prompt and classes from the journal and continues the run.
+    void resumeBatch();
+    void discardResumableBatch();
+
+    // The fields of a job result the labeler uses.
+    struct JobResult
+    {
+        QByteArray  yoloTxt;                // UTF-8, JSON escapes resolved
+        QStringList classNames;
+        bool        hasClassNames = false;  // "class_names" present (even if empty)
+        int         computeMs     = 0;
+    };
+    // Reads a result reply ({"yolo_txt": ..., "class_names": [...], ...})
+    // without building a QJsonDocument: yolo_txt is unescaped straight from
+    // the reply bytes, and only the small class_names array goes through
+    // QJsonDocument. Other fields are skipped. Returns false if the reply is
+    // not a JSON object.
+    static bool parseJobResult(QByteArrayView json, JobResult &out);
+
+    // Validate server-returned YOLO text: each kept line has exactly five
+    // numeric fields with the class ID in range, the center in [0,1] and
+    // the size in (0,1]. Lines are parsed in place and copied out verbatim,
+    // so coordinates keep the server's formatting.
+    static QByteArray filterValidDetections(QByteArrayView yoloTxt, int numClasses);
+    // Same, but maps server class IDs to local ones by case-insensitive
+    // name; lines whose class has no local match are dropped.
+    static QByteArray remapWithClassNames(QByteArrayView yoloTxt,
+                                          const QStringList &serverClassNames,
+                                          const QStringList &localClasses);
+
 signals:
     // Emitted when a label file has been written for one image.
     void labelReady(const QString &imagePath, int nDetections, int computeMs);
@@ -57,48 +146,131 @@ signals:
 #endif
 
 private:
+    // One /v1/jobs/batch submission and the server jobs it created.
+    struct BatchChunk
+    {
+        QStringList     paths;
+        QList<qint64>   jobIds;
+        QVector<int>    statuses;            // 0=pending, 1=succeeded, 2=failed
+        QVector<qint64> nextPollAt;          // per-job poll deadline on m_clock
+        QVector<int>    pollAttempts;        // per-job polls so far, drives backoff
+        QVector<bool>   pollInFlight;
+        qint64          submittedAt    = 0;
+        int             unresolved     = 0;  // jobs neither failed nor fetched yet
+    };
+    using ChunkPtr = std::shared_ptr<BatchChunk>;
+
+    // Upload bytes for one image, valid while the file and settings match.
+    struct PreparedUpload
+    {
+        QByteArray bytes;                    // empty = upload the original file
+        QByteArray mime;
+        QString    fileName;
+        QDateTime  modified;
+        qint64     fileSize = 0;
+        int        maxSide  = 0;
+        int        quality  = 0;
+        QByteArray format;
+    };
+
     // Helpers
     void setBusy(bool busy);
     void resetState();
     void submitSingle(const QString &imagePath, int retryCount = 0);
-    void submitBatchChunk(const QStringList &imagePaths, int retryCount = 0);
     void pollSingle();
-    void pollBatch();
     void fetchSingleResult(int retryCount = 0);
-    void fetchBatchResults(int idx, int retryCount = 0);
     void processNextInQueue();
+    void writeSingleLabel(const JobResult &result);
+    void hashForResultCache(const QStringList &paths, const std::function<void()> &then);
+    void startBatch(const QStringList &paths);
+    void fillBatchWindow();
+    QStringList takeNextChunk();
+    qint64 estimatedUploadBytes(const QString &path);
+    void recordUploadThroughput(qint64 bytes, qint64 ms);
+    void submitBatchChunk(const ChunkPtr &chunk, int retryCount = 0);
+    void schedulePoll();
+    bool handleRateLimit(QNetworkReply *reply, int attempt);
+    void startPollingChunk(const ChunkPtr &chunk);
+    void pollBatch();
+    void pollBatchJob(const ChunkPtr &chunk, int idx);
+    void enqueueFetch(const ChunkPtr &chunk, int idx);
+    void pumpFetchQueue();
+    void fetchBatchResult(const ChunkPtr &chunk, int idx, int retryCount = 0);
+    void writeBatchLabel(const QString &imagePath, const JobResult &result);
+    void finishFetch(const ChunkPtr &chunk);
+    void completeBatchChunk(const ChunkPtr &chunk);
+    void finishBatch();
     void handleFatalError(const QString &message);
+    void prepareUploads(const QStringList &paths, const std::function<void()> &then);
+    const PreparedUpload *preparedFor(const QString &path);
+    bool appendImagePart(QHttpMultiPart *multiPart, const QString &fieldName,
+                         const QString &imagePath);
 
+    static int      nextPollDelay(int attempt);
+    static int      parseRetryAfter(const QByteArray &value, const QDateTime &now);
+    static PreparedUpload prepareUpload(const QString &path, int maxSide, int quality,
+                                        const QByteArray &format);
     static QString  mimeForImage(const QString &path);
-    static void     backupLabelFile(const QString &labelPath);
     static QString  labelPathFor(const QString &imagePath);
-    static QString  filterValidDetections(const QString &yoloTxt, int numClasses);
-    static QString  remapWithClassNames(const QString &yoloTxt,
-                                        const QStringList &serverClassNames,
-                                        const QStringList &localClasses);
     QNetworkRequest makeRequest(const QString &endpoint) const;
+    QString         effectivePrompt() const;
+    QByteArray      labelTextFor(const JobResult &result) const;
+    // Result cache entries hold yolo_txt and class_names as JSON.
+    static JobResult   jobResultFromCache(const QJsonObject &entry);
+    static QJsonObject jobResultToCache(const JobResult &result);
 
     static constexpr const char *API_HOST            = "https://api.yololabel.com";
-    static constexpr int         POLL_INTERVAL        = 1500;  // ms
-    static constexpr int         MAX_POLLS            = 200;   // ~5 min
-    static constexpr int         BATCH_SIZE           = 20;
+    static constexpr int         INITIAL_POLL_INTERVAL = 250;    // ms, first poll after submit
+    static constexpr int         MAX_POLL_INTERVAL     = 4000;   // ms, backoff ceiling
+    static constexpr double      POLL_BACKOFF          = 1.6;
+    static constexpr double      POLL_JITTER           = 0.2;    // +/- fraction of each delay
+    static constexpr qint64      POLL_TIMEOUT_MS       = 300000; // 5 min per job or chunk
+    static constexpr int         BATCH_SIZE           = 20;     // max images per chunk
+    static constexpr int         TARGET_CHUNK_SECONDS = 10;     // upload time per chunk
+    static constexpr qint64      MIN_CHUNK_BYTES      = 512LL * 1024;
+    static constexpr qint64      MAX_CHUNK_BYTES      = 64LL * 1024 * 1024;
+    static constexpr double      INITIAL_UPLOAD_BPS   = 1024.0 * 1024;  // until measured
+    static constexpr double      MIN_UPLOAD_BPS       = 32.0 * 1024;
+    static constexpr double      THROUGHPUT_SMOOTHING = 0.5;
     static constexpr int         MAX_RETRIES          = 3;
-    static constexpr int         MAX_CONCURRENT_POLLS = 5;     // per tick, to avoid rate-limit
+    static constexpr int         MAX_CONCURRENT_POLLS = 5;     // poll requests in flight, to avoid rate-limit
+    static constexpr int         DEFAULT_CHUNKS_IN_FLIGHT = 2;
+    static constexpr int         MAX_CONCURRENT_FETCHES   = 4;  // result GETs across all chunks
+    static constexpr int         DEFAULT_UPLOAD_QUALITY   = 90;
+    static constexpr qint64      UPLOAD_CACHE_BYTES       = 256LL * 1024 * 1024;
 
     QNetworkAccessManager *m_net;
     QTimer                *m_pollTimer;
+    QString                m_apiHost;       // API_HOST unless setApiHost() overrides it
+    QElapsedTimer          m_clock;         // time base for poll deadlines
 
     QString       m_apiKey;
     QString       m_prompt;
     QStringList   m_classes;
 
+    int           m_uploadMaxSide  = 0;    // 0 = upload original files
+    int           m_uploadQuality  = DEFAULT_UPLOAD_QUALITY;
+    QByteArray    m_uploadFormat   = "jpg";
+    QCache<QString, PreparedUpload> m_prepared;   // cost = prepared bytes
+
+    CloudResultCache           m_resultCache;
+    CloudBatchJournal          m_journal;
+    LabelSnapshotStore         m_snapshots;       // one pack per run, opened by setBusy()
+    QHash<QString, QByteArray> m_resultKeys;      // image path -> result cache key, per run
+    QStringList                m_priorityPaths;   // last prioritize() request, per run
+    QSet<QString>              m_userLabeled;     // keepUserLabel() paths, per run
+
     bool          m_busy           = false;
     bool          m_cancelRequested= false;
     int           m_generation     = 0;    // incremented on cancel to invalidate in-flight callbacks
-    int           m_pollCount      = 0;
+    int           m_pollCount      = 0;    // single-image polls so far, drives backoff
+    int           m_pollsInFlight  = 0;
+    qint64        m_pollPausedUntil = 0;   // m_clock time; set by 429/503 Retry-After
 
     // Single-image state
     qint64        m_pendingJobId   = -1;
+    qint64        m_singleSubmittedAt = 0;
+    qint64        m_singleNextPollAt  = 0;
     QString       m_pendingPath;
     QList<int>    m_queue;          // indices into m_allPaths
     int           m_singleWriteOk  = 0;   // write successes for queue-based flow
@@ -107,17 +279,22 @@ private:
     bool          m_singlePolling  = false;
 
     // Batch state
-    bool                m_batchMode     = false;
-    bool                m_batchPolling  = false;
-    QList<qint64>       m_batchJobIds;
-    QVector<int>        m_batchJobStatuses;  // 0=pending, 1=succeeded, 2=failed
-    QStringList         m_batchPaths;
-    QList<QStringList>  m_batchChunks;
-    int                 m_batchTotal              = 0;
-    int                 m_batchDone               = 0;
-    int                 m_batchFailed             = 0;  // cumulative failed count across chunks
-    int                 m_batchChunkWriteSucceeded = 0; // write successes in the current chunk's fetch pass
-    int                 m_pollOffset              = 0;  // round-robin offset for batch polling
+    // Up to m_maxChunksInFlight chunks are active, so chunk k+1 uploads while
+    // chunk k is still being polled or fetched.
+    bool                m_batchMode         = false;
+    bool                m_batchUploading    = false;  // one chunk upload at a time
+    bool                m_batchHashing      = false;  // cache keys for unqueued images pending
+    int                 m_maxChunksInFlight = DEFAULT_CHUNKS_IN_FLIGHT;
+    QList<ChunkPtr>     m_activeChunks;
+    QList<ChunkPtr>     m_resumedChunks;              // journaled jobs not yet polled
+    QStringList         m_batchPending;               // not yet submitted, in upload order
+    double              m_uploadBytesPerSec = INITIAL_UPLOAD_BPS;  // measured, kept across runs
+    double              m_prepRatio         = 1.0;    // prepared / original bytes, learned
+    QList<QPair<ChunkPtr, int>> m_fetchQueue;         // (chunk, job index) awaiting a result GET
+    int                 m_fetchesInFlight   = 0;
+    int                 m_batchTotal        = 0;
+    int                 m_batchDone         = 0;
+    int                 m_batchFailed       = 0;      // cumulative failed count across chunks
 
     QStringList   m_allPaths;  // full image list for queue-based "label all"
 };
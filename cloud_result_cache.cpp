@@ -0,0 +1,120 @@
+#include "cloud_result_cache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+CloudResultCache::CloudResultCache(const QString &directory, qint64 maxBytes)
+    : m_dir(directory), m_maxBytes(maxBytes)
+{
+}
+
+QString CloudResultCache::defaultDirectory()
+{
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return base.isEmpty() ? QString() : base + "/cloud_results";
+}
+
+QByteArray CloudResultCache::contentHash(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&f)) return QByteArray();
+    return hash.result();
+}
+
+QByteArray CloudResultCache::key(const QByteArray &contentHash, const QString &prompt,
+                                 const QStringList &classes)
+{
+    if (contentHash.isEmpty()) return QByteArray();
+
+    // Length-prefix the text fields so ("a;b", "c") and ("a", "b;c") differ.
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(contentHash);
+    const QByteArray p = prompt.toUtf8();
+    hash.addData(QByteArray::number(p.size()) + ':' + p);
+    for (const QString &c : classes) {
+        const QByteArray b = c.toUtf8();
+        hash.addData(QByteArray::number(b.size()) + ':' + b);
+    }
+    return hash.result().toHex();
+}
+
+// Entries are fanned out over 256 subdirectories by the first key byte.
+QString CloudResultCache::entryPath(const QByteArray &key) const
+{
+    return m_dir + '/' + QString::fromLatin1(key.left(2)) + '/'
+           + QString::fromLatin1(key) + ".json";
+}
+
+bool CloudResultCache::lookup(const QByteArray &key, QJsonObject &result) const
+{
+    if (!isEnabled() || key.isEmpty()) return false;
+
+    // Opened for writing only so the hit can bump the modification time
+    // prune() sorts by; a read-only cache still serves hits.
+    QFile f(entryPath(key));
+    if (!f.open(QIODevice::ReadWrite | QIODevice::ExistingOnly)
+        && !f.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject() || !doc.object().contains("yolo_txt")) return false;
+    result = doc.object();
+    if (f.isWritable())
+        f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+
+void CloudResultCache::store(const QByteArray &key, const QJsonObject &result) const
+{
+    if (!isEnabled() || key.isEmpty()) return;
+
+    QJsonObject entry;
+    entry["yolo_txt"] = result.value("yolo_txt");
+    if (result.contains("class_names"))
+        entry["class_names"] = result.value("class_names");
+
+    const QString path = entryPath(key);
+    QDir().mkpath(QFileInfo(path).path());
+
+    // QSaveFile writes to a temporary file and renames it on commit, so a
+    // crash never leaves a truncated entry behind.
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return;
+    f.write(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+    f.commit();
+}
+
+void CloudResultCache::prune() const
+{
+    if (!isEnabled()) return;
+
+    struct Entry { QString path; qint64 size; QDateTime used; };
+    QList<Entry> entries;
+    qint64 total = 0;
+    QDirIterator it(m_dir, { "*.json" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QFileInfo fi = it.nextFileInfo();
+        entries.append({ fi.absoluteFilePath(), fi.size(), fi.lastModified() });
+        total += fi.size();
+    }
+    if (total <= m_maxBytes) return;
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) { return a.used < b.used; });
+    for (const Entry &e : entries) {
+        if (total <= m_maxBytes) break;
+        if (QFile::remove(e.path))
+            total -= e.size;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef CLOUD_RESULT_CACHE_H
+#define CLOUD_RESULT_CACHE_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+// On-disk cache of cloud inference results keyed by image content, effective
+// prompt and class list, so re-running "Auto Label All AI" after a cancel or
+// crash does not upload images the server has already labeled. Each entry is
+// the server's result object reduced to yolo_txt and class_names, stored as
+// one small JSON file. Lookups and stores may run on any thread. The cache is
+// kept under maxBytes by prune(), which drops the least recently used
+// entries; a hit refreshes its entry's modification time.
+class CloudResultCache
+{
+public:
+    static constexpr qint64 DEFAULT_MAX_BYTES = 32ll * 1024 * 1024;
+
+    // An empty directory disables the cache.
+    explicit CloudResultCache(const QString &directory = defaultDirectory(),
+                              qint64 maxBytes = DEFAULT_MAX_BYTES);
+
+    static QString defaultDirectory();
+
+    // SHA-256 of the file bytes; empty if the file cannot be read.
+    static QByteArray contentHash(const QString &path);
+    // Hex key for one (content, prompt, classes) combination; empty when
+    // contentHash is empty.
+    static QByteArray key(const QByteArray &contentHash, const QString &prompt,
+                          const QStringList &classes);
+
+    bool    isEnabled() const { return !m_dir.isEmpty(); }
+    QString directory() const { return m_dir; }
+    qint64  maxBytes() const  { return m_maxBytes; }
+
+    bool lookup(const QByteArray &key, QJsonObject &result) const;
+    void store(const QByteArray &key, const QJsonObject &result) const;
+    // Deletes the oldest entries by modification time until the cache fits
+    // in maxBytes. Walks the whole directory, so call it once per run, not
+    // per store.
+    void prune() const;
+
+private:
+    QString entryPath(const QByteArray &key) const;
+
+    QString m_dir;
+    qint64  m_maxBytes;
+};
+
+#endif // CLOUD_RESULT_CACHE_H
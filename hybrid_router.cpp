@@ -0,0 +1,40 @@
+#include "hybrid_router.h"
+
+#include <algorithm>
+
+HybridRouter::Decision HybridRouter::route(
+    const std::vector<DetectionResult>& detections,
+    const RoutingThresholds& thresholds)
+{
+    if (static_cast<int>(detections.size()) < thresholds.minDetections)
+        return Decision::FewDetections;
+
+    float topConfidence = 0.0f;
+    for (const auto& det : detections)
+        topConfidence = std::max(topConfidence, det.confidence);
+    if (!detections.empty() && topConfidence < thresholds.minTopConfidence)
+        return Decision::LowConfidence;
+
+    if (disagreement(detections, thresholds.overlapIou) > thresholds.maxDisagreement)
+        return Decision::Disagreement;
+
+    return Decision::Local;
+}
+
+float HybridRouter::disagreement(const std::vector<DetectionResult>& detections,
+                                 float iouThreshold)
+{
+    if (detections.empty()) return 0.0f;
+
+    int contested = 0;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        for (size_t j = 0; j < detections.size(); ++j) {
+            if (i == j || detections[i].classId == detections[j].classId) continue;
+            if (YoloDetector::iou(detections[i], detections[j]) >= iouThreshold) {
+                ++contested;
+                break;
+            }
+        }
+    }
+    return static_cast<float>(contested) / static_cast<float>(detections.size());
+}
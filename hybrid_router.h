@@ -0,0 +1,37 @@
+#ifndef HYBRID_ROUTER_H
+#define HYBRID_ROUTER_H
+
+#include <vector>
+
+#include "yolo_detector.h"
+
+// Thresholds for local-first labeling. An image keeps its local labels only
+// if the model is confident about it; anything else goes to the cloud API.
+struct RoutingThresholds {
+    float minTopConfidence = 0.5f;   // best detection must reach this
+    int   minDetections    = 1;      // fewer boxes than this is suspicious
+    float maxDisagreement  = 0.25f;  // fraction of boxes contested by another class
+    float overlapIou       = 0.5f;   // boxes overlapping this much describe one object
+};
+
+// Decides, from the local detector's output, whether an image can keep its
+// local labels or needs a second opinion from CloudAutoLabeler.
+class HybridRouter {
+public:
+    enum class Decision {
+        Local,          // confident: write local labels
+        LowConfidence,  // best detection below minTopConfidence
+        FewDetections,  // fewer than minDetections boxes
+        Disagreement    // overlapping boxes with different classes
+    };
+
+    static Decision route(const std::vector<DetectionResult>& detections,
+                          const RoutingThresholds& thresholds);
+
+    // Fraction of detections that overlap a box of a different class by at
+    // least iouThreshold, i.e. where the model could not settle on a class.
+    static float disagreement(const std::vector<DetectionResult>& detections,
+                              float iouThreshold);
+};
+
+#endif // HYBRID_ROUTER_H
@@ -0,0 +1,112 @@
+#include "image_cache.h"
+#include "trace.h"
+
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QThreadPool>
+
+ImageCache& ImageCache::instance()
+{
+    static ImageCache cache;
+    return cache;
+}
+
+ImageCache::ImageCache()
+{
+    m_cache.setMaxCost(DEFAULT_BYTE_BUDGET);
+}
+
+QImage ImageCache::decode(const QString &path)
+{
+    TRACE_SCOPE("ImageCache", "decode");
+    QImageReader imgReader(path);
+    imgReader.setAllocationLimit(0);
+    imgReader.setAutoTransform(true);
+    return imgReader.read();
+}
+
+bool ImageCache::lookup(const QString &path, const QDateTime &modified, qint64 fileSize, QImage &out)
+{
+    Entry *entry = m_cache.object(path);
+    if (!entry) return false;
+
+    if (entry->modified != modified || entry->fileSize != fileSize) {
+        m_cache.remove(path);   // file changed on disk
+        return false;
+    }
+    out = entry->image;
+    return true;
+}
+
+QImage ImageCache::load(const QString &path)
+{
+    const QFileInfo info(path);
+    const QDateTime modified = info.lastModified();
+    const qint64    fileSize = info.size();
+
+    QMutexLocker locker(&m_mutex);
+
+    // Wait for a prefetch of the same file instead of decoding it twice
+    while (m_inFlight.contains(path))
+        m_decoded.wait(&m_mutex);
+
+    QImage img;
+    if (lookup(path, modified, fileSize, img)) return img;
+
+    m_inFlight.insert(path);
+    locker.unlock();
+
+    img = decode(path);
+
+    locker.relock();
+    m_inFlight.remove(path);
+    if (!img.isNull())
+        m_cache.insert(path, new Entry{img, modified, fileSize}, img.sizeInBytes());
+    m_decoded.wakeAll();
+
+    return img;
+}
+
+QImage ImageCache::peek(const QString &path)
+{
+    const QFileInfo info(path);
+
+    QMutexLocker locker(&m_mutex);
+    QImage img;
+    lookup(path, info.lastModified(), info.size(), img);
+    return img;
+}
+
+void ImageCache::prefetch(const QString &path)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_inFlight.contains(path) || m_cache.contains(path)) return;
+    }
+    QThreadPool::globalInstance()->start([this, path]() { load(path); });
+}
+
+void ImageCache::setByteBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.setMaxCost(bytes);
+}
+
+qint64 ImageCache::byteBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
+
+qint64 ImageCache::bytesUsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.totalCost();
+}
+
+void ImageCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
@@ -0,0 +1,59 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <QCache>
+#include <QDateTime>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QWaitCondition>
+
+// Process-wide cache of decoded images keyed by file path and validated
+// against the file's modification time and size. Entries are QImage copies,
+// so the display, the detector and prefetchers share one decoded buffer
+// through Qt's implicit sharing. Eviction is LRU within a byte budget.
+// All methods are thread-safe.
+class ImageCache
+{
+public:
+    static ImageCache& instance();
+
+    // Returns the decoded image (EXIF orientation applied), decoding it at
+    // most once while it stays cached. A null QImage means unreadable.
+    QImage load(const QString &path);
+
+    // Returns the cached image if it is still valid, without decoding.
+    QImage peek(const QString &path);
+
+    // Decodes path on the global thread pool so a later load() is a hit.
+    void   prefetch(const QString &path);
+
+    void   setByteBudget(qint64 bytes);
+    qint64 byteBudget() const;
+    qint64 bytesUsed() const;
+    void   clear();
+
+    static QImage decode(const QString &path);
+
+    static constexpr qint64 DEFAULT_BYTE_BUDGET = 512LL * 1024 * 1024;
+
+private:
+    ImageCache();
+
+    struct Entry
+    {
+        QImage    image;
+        QDateTime modified;
+        qint64    fileSize;
+    };
+
+    bool lookup(const QString &path, const QDateTime &modified, qint64 fileSize, QImage &out);
+
+    mutable QMutex         m_mutex;
+    QWaitCondition         m_decoded;
+    QCache<QString, Entry> m_cache;   // cost = image bytes
+    QSet<QString>          m_inFlight;
+};
+
+#endif // IMAGE_CACHE_H
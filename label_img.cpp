@@ -1,6 +1,8 @@
 #include "label_img.h"
+#include "image_cache.h"
+#include "trace.h"
 #include <QPainter>
-#include <QImageReader>
+#include <QScreen>
 #include <math.h>       /* fabs */
 #include <algorithm>
 
@@ -19,7 +21,34 @@ QColor label_img::BOX_COLORS[10] ={  Qt::green,
 
 label_img::label_img(QWidget *parent)
     :QLabel(parent)
-{
+    , m_gamma(1.0f)
+    , m_gammaImgSourceKey(0)
+    , m_gammaImgGamma(1.0f)
+    , m_refineTimer(new QTimer(this))
+    , m_levelImgSourceKey(0)
+    , m_levelImgDivisor(1)
+    , m_frameTimer(new QTimer(this))
+    , m_pendingInputEvents(0)
+    , m_zoomedImgSourceKey(0)
+    , m_zoomedImgZoom(0.0)
+    , m_zoomedImgCoarse(false)
+{
+    for(int i = 0; i < 256; i++)
+        m_gammatransform_lut[i] = (unsigned char)i;
+
+    m_refineTimer->setSingleShot(true);
+    m_refineTimer->setInterval(REFINE_DELAY_MS);
+    connect(m_refineTimer, &QTimer::timeout, this, [this]() {
+        m_bZoomBurst = false;
+        // A pending frame will already be drawn at full quality
+        if(m_bCoarseFrame && !isInteracting() && !m_frameTimer->isActive())
+            showImage();
+    });
+
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &label_img::presentFrame);
+
     init();
 }
 
@@ -33,7 +62,7 @@ void label_img::mouseMoveEvent(QMouseEvent *ev)
         m_panOffset.setX(m_panStartOffset.x() - static_cast<double>(dx) / (m_zoomFactor * this->width()));
         m_panOffset.setY(m_panStartOffset.y() - static_cast<double>(dy) / (m_zoomFactor * this->height()));
         clampPanOffset();
-        showImage();
+        requestRepaint();
         return;
     }
 
@@ -79,7 +108,7 @@ void label_img::mouseMoveEvent(QMouseEvent *ev)
         setCursor(Qt::ClosedHandCursor);
     }
 
-    showImage();
+    requestRepaint();
     emit Mouse_Moved();
 }
 
@@ -90,7 +119,7 @@ void label_img::mousePressEvent(QMouseEvent *ev)
     if(ev->button() == Qt::LeftButton && (ev->modifiers() & Qt::AltModifier) && !m_bLabelingStarted)
     {
         setFocusedObjectBoxLabel(m_relative_mouse_pos_in_ui, m_focusedObjectLabel);
-        showImage();
+        requestRepaint();
         emit Mouse_Pressed();
         return;
     }
@@ -110,7 +139,7 @@ void label_img::mousePressEvent(QMouseEvent *ev)
     if(ev->button() == Qt::RightButton)
     {
         removeFocusedObjectBox(m_relative_mouse_pos_in_ui);
-        showImage();
+        requestRepaint();
     }
     else if(ev->button() == Qt::LeftButton)
     {
@@ -154,7 +183,7 @@ void label_img::mousePressEvent(QMouseEvent *ev)
             releaseMouse();
             m_bLabelingStarted              = false;
 
-            showImage();
+            requestRepaint();
         }
     }
 
@@ -189,6 +218,10 @@ void label_img::mouseReleaseEvent(QMouseEvent *ev)
         else
             setCursor(Qt::CrossCursor);
     }
+
+    if(m_bCoarseFrame)
+        m_refineTimer->start();
+
     emit Mouse_Release();
 }
 
@@ -204,6 +237,8 @@ void label_img::init()
     m_zoomFactor                    = 1.0;
     m_panOffset                     = QPointF(0.0, 0.0);
     m_bPanning                      = false;
+    m_bZoomBurst                    = false;
+    m_bCoarseFrame                  = false;
 
     QPoint mousePosInUi = this->mapFromGlobal(QCursor::pos());
     bool mouse_is_in_image = QRect(0, 0, this->width(), this->height()).contains(mousePosInUi);
@@ -231,10 +266,8 @@ void label_img::setMousePosition(int x, int y)
 
 void label_img::openImage(const QString &qstrImg, bool &ret)
 {
-    QImageReader imgReader(qstrImg);
-    imgReader.setAllocationLimit(0);
-    imgReader.setAutoTransform(true);
-    QImage img = imgReader.read();
+    TRACE_SCOPE("label_img", "openImage");
+    QImage img = ImageCache::instance().load(qstrImg);
 
     if(img.isNull())
     {
@@ -250,6 +283,8 @@ void label_img::openImage(const QString &qstrImg, bool &ret)
         m_inputImg          = std::move(img);
         m_resized_inputImg  = m_inputImg.scaled(this->width(), this->height(),Qt::IgnoreAspectRatio,Qt::SmoothTransformation)
                 .convertToFormat(QImage::Format_RGB888);
+        m_levelImg          = QImage();
+        m_zoomedImg         = QImage();
 
         if (m_bLabelingStarted) releaseMouse();
         m_bLabelingStarted  = false;
@@ -270,10 +305,79 @@ void label_img::openImage(const QString &qstrImg, bool &ret)
 
 void label_img::showImage()
 {
+    TRACE_SCOPE("label_img", "showImage");
     if(m_inputImg.isNull()) return;
 
-    QImage img;
+    QImage img = applyContrast(scaledView());
+
+    QPainter painter(&img);
+    QFont font = painter.font();
+    int fontSize = 16, xMargin = 5, yMargin = 2;
+    font.setPixelSize(fontSize);
+    font.setBold(true);
+    painter.setFont(font);
+
+    int penThick = 3;
+
+    QColor crossLineColor(255, 187, 0);
+
+    drawCrossLine(painter, crossLineColor, penThick);
+    drawFocusedObjectBox(painter, Qt::magenta, penThick);
+    drawObjectBoxes(painter, penThick);
+    if(m_bVisualizeClassName)
+        drawObjectLabels(painter, penThick, fontSize, xMargin, yMargin);
+
+    this->setPixmap(QPixmap::fromImage(img));
+}
+
+void label_img::requestRepaint()
+{
+    ++m_pendingInputEvents;
+    if(m_frameTimer->isActive()) return;
+
+    m_inputClock.start(); // oldest input not yet on screen
+
+    qreal hz = screen() ? screen()->refreshRate() : 0.0;
+    if(hz <= 0.0) hz = 60.0;
+    int period    = static_cast<int>(1000.0 / hz);
+    int sinceLast = m_lastFrameClock.isValid() ? static_cast<int>(m_lastFrameClock.elapsed()) : period;
+
+    m_frameTimer->start(std::max(0, period - sinceLast));
+}
+
+void label_img::presentFrame()
+{
+    showImage();
+
+    double ms = m_inputClock.nsecsElapsed() / 1e6;
+    m_frameStats.frames++;
+    m_frameStats.coalescedEvents += m_pendingInputEvents;
+    m_frameStats.lastMs = ms;
+    m_frameStats.maxMs  = std::max(m_frameStats.maxMs, ms);
+    m_frameStats.avgMs += (ms - m_frameStats.avgMs) / m_frameStats.frames;
 
+    m_pendingInputEvents = 0;
+    m_lastFrameClock.start();
+}
+
+const FrameLatencyStats& label_img::frameLatencyStats() const
+{
+    return m_frameStats;
+}
+
+void label_img::resetFrameLatencyStats()
+{
+    m_frameStats = FrameLatencyStats();
+}
+
+bool label_img::isInteracting() const
+{
+    return m_bPanning || m_bDragging || m_bZoomBurst;
+}
+
+QImage label_img::scaledView()
+{
+    TRACE_SCOPE("label_img", "scaledView");
     if(m_zoomFactor <= 1.0)
     {
         if(m_resized_inputImg.width() != this->width() || m_resized_inputImg.height() != this->height())
@@ -281,12 +385,26 @@ void label_img::showImage()
             m_resized_inputImg = m_inputImg.scaled(this->width(), this->height(),Qt::IgnoreAspectRatio,Qt::SmoothTransformation)
                     .convertToFormat(QImage::Format_RGB888);
         }
-        img = m_resized_inputImg;
+        m_bCoarseFrame = false;
+        return m_resized_inputImg;
     }
-    else
+
+    const bool coarse = isInteracting();
+
+    // A smooth frame of the same view is always good enough to reuse
+    bool cached = !m_zoomedImg.isNull()
+            && m_zoomedImg.size()   == this->size()
+            && m_zoomedImgSourceKey == m_inputImg.cacheKey()
+            && m_zoomedImgZoom      == m_zoomFactor
+            && m_zoomedImgPan       == m_panOffset
+            && (coarse || !m_zoomedImgCoarse);
+
+    if(!cached)
     {
-        int imgW = m_inputImg.width();
-        int imgH = m_inputImg.height();
+        const QImage &src = coarse ? interactionLevel() : m_inputImg;
+
+        int imgW = src.width();
+        int imgH = src.height();
 
         int visX = static_cast<int>(m_panOffset.x() * imgW);
         int visY = static_cast<int>(m_panOffset.y() * imgH);
@@ -298,35 +416,47 @@ void label_img::showImage()
         visW = std::max(1, std::min(visW, imgW - visX));
         visH = std::max(1, std::min(visH, imgH - visY));
 
-        QImage cropped = m_inputImg.copy(visX, visY, visW, visH);
-        img = cropped.scaled(this->width(), this->height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+        QImage cropped = src.copy(visX, visY, visW, visH);
+        m_zoomedImg = cropped.scaled(this->width(), this->height(), Qt::IgnoreAspectRatio,
+                                     coarse ? Qt::FastTransformation : Qt::SmoothTransformation)
                 .convertToFormat(QImage::Format_RGB888);
+        m_zoomedImgSourceKey = m_inputImg.cacheKey();
+        m_zoomedImgZoom      = m_zoomFactor;
+        m_zoomedImgPan       = m_panOffset;
+        m_zoomedImgCoarse    = coarse;
     }
 
-    gammaTransform(img);
+    m_bCoarseFrame = m_zoomedImgCoarse;
+    if(m_bCoarseFrame)
+        m_refineTimer->start();
 
-    QPainter painter(&img);
-    QFont font = painter.font();
-    int fontSize = 16, xMargin = 5, yMargin = 2;
-    font.setPixelSize(fontSize);
-    font.setBold(true);
-    painter.setFont(font);
+    return m_zoomedImg;
+}
 
-    int penThick = 3;
+const QImage& label_img::interactionLevel()
+{
+    // Largest power-of-two reduction that still has at least as many pixels
+    // as the zoomed view shows, so fast scaling only ever samples downwards.
+    int divisor = 1;
+    while(m_inputImg.width()  / (divisor * 2) >= this->width()  * m_zoomFactor &&
+          m_inputImg.height() / (divisor * 2) >= this->height() * m_zoomFactor)
+        divisor *= 2;
 
-    QColor crossLineColor(255, 187, 0);
+    if(divisor == 1) return m_inputImg;
 
-    drawCrossLine(painter, crossLineColor, penThick);
-    drawFocusedObjectBox(painter, Qt::magenta, penThick);
-    drawObjectBoxes(painter, penThick);
-    if(m_bVisualizeClassName)
-        drawObjectLabels(painter, penThick, fontSize, xMargin, yMargin);
-
-    this->setPixmap(QPixmap::fromImage(img));
+    if(m_levelImg.isNull() || m_levelImgSourceKey != m_inputImg.cacheKey() || m_levelImgDivisor != divisor)
+    {
+        m_levelImg = m_inputImg.scaled(m_inputImg.width() / divisor, m_inputImg.height() / divisor,
+                                       Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        m_levelImgSourceKey = m_inputImg.cacheKey();
+        m_levelImgDivisor   = divisor;
+    }
+    return m_levelImg;
 }
 
 void label_img::loadLabelData(const QString& labelFilePath)
 {
+    TRACE_SCOPE("label_img", "loadLabelData");
     ifstream inputFile(qPrintable(labelFilePath));
 
     if(inputFile.is_open())
@@ -464,23 +594,48 @@ void label_img::drawObjectLabels(QPainter& painter, int thickWidth, int fontPixe
 
 void label_img::gammaTransform(QImage &image)
 {
-    int h = image.height();
-    int w = image.width();
-    int stride = image.bytesPerLine();
+    // Every channel shares one LUT, so each RGB888 scanline is walked as a
+    // flat byte run; the unrolled body lets the compiler pipeline the loads.
+    const int h        = image.height();
+    const int rowBytes = image.width() * 3;
+    const int stride   = image.bytesPerLine();
+    const unsigned char *lut = m_gammatransform_lut;
+    uchar *bits = image.bits();
 
     for(int y = 0 ; y < h; ++y)
     {
-        uchar* row = image.bits() + y * stride;
-        for(int x = 0; x < w; ++x)
+        uchar* row = bits + y * stride;
+        int x = 0;
+        for(; x + 8 <= rowBytes; x += 8)
         {
-            int offset = x * 3;
-            row[offset + 0] = m_gammatransform_lut[row[offset + 0]];
-            row[offset + 1] = m_gammatransform_lut[row[offset + 1]];
-            row[offset + 2] = m_gammatransform_lut[row[offset + 2]];
+            row[x + 0] = lut[row[x + 0]];
+            row[x + 1] = lut[row[x + 1]];
+            row[x + 2] = lut[row[x + 2]];
+            row[x + 3] = lut[row[x + 3]];
+            row[x + 4] = lut[row[x + 4]];
+            row[x + 5] = lut[row[x + 5]];
+            row[x + 6] = lut[row[x + 6]];
+            row[x + 7] = lut[row[x + 7]];
         }
+        for(; x < rowBytes; ++x)
+            row[x] = lut[row[x]];
     }
 }
 
+QImage label_img::applyContrast(const QImage &view)
+{
+    if(m_gamma == 1.0f) return view; // identity LUT
+
+    if(m_gammaImg.isNull() || m_gammaImgSourceKey != view.cacheKey() || m_gammaImgGamma != m_gamma)
+    {
+        m_gammaImg = view.copy();
+        gammaTransform(m_gammaImg);
+        m_gammaImgSourceKey = view.cacheKey();
+        m_gammaImgGamma     = m_gamma;
+    }
+    return m_gammaImg;
+}
+
 bool label_img::removeFocusedObjectBox(QPointF point)
 {
     int     removeBoxIdx = -1;
@@ -518,6 +673,7 @@ void label_img::clearAllBoxes()
 
 void label_img::saveState()
 {
+    TRACE_SCOPE("label_img", "saveState");
     if(m_undoHistory.size() >= MAX_UNDO_HISTORY)
         m_undoHistory.removeFirst();
     m_undoHistory.append(m_objBoundingBoxes);
@@ -583,7 +739,7 @@ void label_img::moveBox(int boxIdx, double dx, double dy)
 
     box.moveLeft(newX);
     box.moveTop(newY);
-    showImage();
+    requestRepaint();
 }
 
 void label_img::resizeBox(int boxIdx, double dw, double dh)
@@ -605,7 +761,7 @@ void label_img::resizeBox(int boxIdx, double dw, double dh)
 
     box.setWidth(newW);
     box.setHeight(newH);
-    showImage();
+    requestRepaint();
 }
 
 void label_img::setFocusedObjectBoxLabel(QPointF point, int newLabel)
@@ -659,13 +815,17 @@ QPointF label_img::cvtAbsoluteToRelativePoint(QPoint p)
 
 void label_img::setContrastGamma(float gamma)
 {
-    for(int i=0; i < 256; i++)
+    if(gamma != m_gamma)
     {
-        int s = (int)(pow((float)i/255., gamma) * 255.);
-        s = std::clamp(s, 0, 255);
-        m_gammatransform_lut[i] = (unsigned char)s;
+        m_gamma = gamma;
+        for(int i=0; i < 256; i++)
+        {
+            int s = (int)(pow((float)i/255., gamma) * 255.);
+            s = std::clamp(s, 0, 255);
+            m_gammatransform_lut[i] = (unsigned char)s;
+        }
     }
-    showImage();
+    requestRepaint();
 }
 
 void label_img::wheelEvent(QWheelEvent *ev)
@@ -691,12 +851,14 @@ void label_img::zoomIn(QPoint widgetPos)
     QPointF relPos = cvtAbsoluteToRelativePoint(widgetPos);
 
     m_zoomFactor = std::min(m_zoomFactor * 1.05, 10.0);
+    m_bZoomBurst = true;
+    m_refineTimer->start();
 
     m_panOffset.setX(relPos.x() - static_cast<double>(widgetPos.x()) / (m_zoomFactor * this->width()));
     m_panOffset.setY(relPos.y() - static_cast<double>(widgetPos.y()) / (m_zoomFactor * this->height()));
 
     clampPanOffset();
-    showImage();
+    requestRepaint();
 }
 
 void label_img::zoomOut(QPoint widgetPos)
@@ -706,6 +868,8 @@ void label_img::zoomOut(QPoint widgetPos)
     QPointF relPos = cvtAbsoluteToRelativePoint(widgetPos);
 
     m_zoomFactor = std::max(m_zoomFactor / 1.05, 1.0);
+    m_bZoomBurst = true;
+    m_refineTimer->start();
 
     if(m_zoomFactor <= 1.0)
     {
@@ -719,7 +883,7 @@ void label_img::zoomOut(QPoint widgetPos)
         clampPanOffset();
     }
 
-    showImage();
+    requestRepaint();
 }
 
 void label_img::resetZoom()
@@ -6,6 +6,8 @@
 #include <QImage>
 #include <QMouseEvent>
 #include <QWheelEvent>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <fstream>
 
 struct ObjectLabelingBox
@@ -14,6 +16,17 @@ struct ObjectLabelingBox
     QRectF  box;
 };
 
+// Input-to-present latency of repaints requested by user input: mouse, wheel
+// zoom, contrast, undo/redo, paste and nudge (see requestRepaint()).
+struct FrameLatencyStats
+{
+    int     frames          = 0;    // repaints presented through requestRepaint()
+    int     coalescedEvents = 0;    // input events folded into those repaints
+    double  lastMs          = 0.0;  // oldest pending input -> pixmap updated
+    double  maxMs           = 0.0;
+    double  avgMs           = 0.0;
+};
+
 class label_img : public QLabel
 {
     Q_OBJECT
@@ -45,6 +58,10 @@ public:
     void init();
     void openImage(const QString &, bool& ret);
     void showImage();
+    void requestRepaint();
+
+    const FrameLatencyStats& frameLatencyStats() const;
+    void resetFrameLatencyStats();
 
     void loadLabelData(const QString & );
 
@@ -58,6 +75,8 @@ public:
     bool undo();
     bool redo();
     void clearUndoHistory();
+    // Edited since the labels were loaded (undoing every edit clears it).
+    bool isModified() const { return !m_undoHistory.isEmpty(); }
 
     void moveBox(int boxIdx, double dx, double dy);
     void resizeBox(int boxIdx, double dw, double dh);
@@ -95,6 +114,14 @@ private:
     unsigned char m_gammatransform_lut[256];
     QVector<QRgb> colorTable;
 
+    float   m_gamma;
+
+    // Gamma-adjusted copy of the current view, reused until the scaled view
+    // (tracked through its QImage::cacheKey) or the gamma value changes.
+    QImage  m_gammaImg;
+    qint64  m_gammaImgSourceKey;
+    float   m_gammaImgGamma;
+
     static const int MAX_UNDO_HISTORY = 50;
     QVector< QVector<ObjectLabelingBox> > m_undoHistory;
     QVector< QVector<ObjectLabelingBox> > m_redoHistory;
@@ -111,14 +138,46 @@ private:
     QPoint  m_panStartWidgetPos;
     QPointF m_panStartOffset;
 
+    // Interactive states (pan, box drag, wheel-zoom burst) render with fast
+    // scaling of a reduced level; m_refineTimer redraws smoothly once idle.
+    static const int REFINE_DELAY_MS = 120;
+    QTimer *m_refineTimer;
+    bool    m_bZoomBurst;
+    bool    m_bCoarseFrame;
+
+    QImage  m_levelImg;
+    qint64  m_levelImgSourceKey;
+    int     m_levelImgDivisor;
+
+    // Input (mouse, wheel zoom, box nudges, undo, contrast slider) only
+    // marks the view dirty; m_frameTimer repaints at most once per display
+    // refresh and records the latency in m_frameStats.
+    QTimer           *m_frameTimer;
+    QElapsedTimer     m_inputClock;
+    QElapsedTimer     m_lastFrameClock;
+    int               m_pendingInputEvents;
+    FrameLatencyStats m_frameStats;
+
+    QImage  m_zoomedImg;
+    qint64  m_zoomedImgSourceKey;
+    double  m_zoomedImgZoom;
+    QPointF m_zoomedImgPan;
+    bool    m_zoomedImgCoarse;
+
     void setMousePosition(int , int);
     void clampPanOffset();
 
+    bool isInteracting() const;
+    QImage scaledView();
+    const QImage& interactionLevel();
+    void presentFrame();
+
     void drawCrossLine(QPainter& , QColor , int thickWidth = 3);
     void drawFocusedObjectBox(QPainter& , Qt::GlobalColor , int thickWidth = 3);
     void drawObjectBoxes(QPainter& , int thickWidth = 3);
     void drawObjectLabels(QPainter& , int thickWidth = 3, int fontPixelSize = 14, int xMargin = 5, int yMargin = 2);
     void gammaTransform(QImage& image);
+    QImage applyContrast(const QImage& view);
     bool removeFocusedObjectBox(QPointF);
 
 protected:
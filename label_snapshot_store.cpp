@@ -0,0 +1,183 @@
+#include "label_snapshot_store.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+LabelSnapshotStore::LabelSnapshotStore(const QString &dir)
+    : m_dir(dir)
+{
+}
+
+LabelSnapshotStore::~LabelSnapshotStore()
+{
+    endRun();
+}
+
+QString LabelSnapshotStore::defaultDirectory()
+{
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return base.isEmpty() ? QString() : base + "/label_snapshots";
+}
+
+void LabelSnapshotStore::setDirectory(const QString &dir)
+{
+    endRun();
+    m_dir = dir;
+}
+
+void LabelSnapshotStore::beginRun()
+{
+    endRun();
+    m_inRun = isEnabled();
+}
+
+void LabelSnapshotStore::snapshot(const QString &labelPath, const QByteArray &newContents)
+{
+    if (!m_inRun || m_seen.contains(labelPath)) return;
+
+    QJsonObject record{ { "path", labelPath } };
+    QFile f(labelPath);
+    if (f.open(QIODevice::ReadOnly)) {
+        const QByteArray old = f.readAll();
+        if (old == newContents) return;        // nothing to preserve yet
+        if (old.contains('\r') && QByteArray(old).replace("\r\n", "\n") == newContents)
+            return;                            // same label, written on Windows
+        record["base64"] = QString::fromLatin1(old.toBase64());
+    } else if (f.exists()) {
+        return;                                // unreadable; leave it alone
+    } else {
+        record["absent"] = true;               // created by this run
+    }
+    m_seen.insert(labelPath);
+
+    if (m_packPath.isEmpty()) {
+        QDir().mkpath(m_dir);
+        const QDateTime now  = QDateTime::currentDateTime();
+        const QString   stem = m_dir + "/" + now.toString("yyyyMMdd-HHmmss-zzz");
+        // Names sort in creation order, even for runs within one millisecond
+        int k = 0;
+        do {
+            m_packPath = stem + QString("-%1.pack").arg(k++, 2, 10, QChar('0'));
+        } while (QFile::exists(m_packPath));
+        append(QJsonDocument(QJsonObject{ { "type", "run" },
+                                          { "created", now.toString(Qt::ISODateWithMs) } })
+                   .toJson(QJsonDocument::Compact) + '\n');
+    }
+    append(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    ++m_count;
+}
+
+void LabelSnapshotStore::endRun()
+{
+    waitForFlush();
+    m_file.reset();
+    const bool wrote = !m_packPath.isEmpty();
+    m_packPath.clear();
+    m_seen.clear();
+    m_count = 0;
+    m_inRun = false;
+    if (wrote) prune();
+}
+
+// Buffers one record and starts a flush task unless one is already running;
+// the running task picks the record up before it exits.
+void LabelSnapshotStore::append(const QByteArray &record)
+{
+    QMutexLocker lock(&m_mutex);
+    m_pending += record;
+    if (m_flushing) return;
+    m_flushing = true;
+    if (!m_file)
+        m_file = std::make_unique<QFile>(m_packPath);
+    QThreadPool::globalInstance()->start([this]() { flushPending(); });
+}
+
+void LabelSnapshotStore::flushPending()
+{
+    for (;;) {
+        QByteArray chunk;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_pending.isEmpty()) {
+                m_flushing = false;
+                m_flushDone.wakeAll();
+                return;
+            }
+            chunk.swap(m_pending);
+        }
+        if (m_file->isOpen() || m_file->open(QIODevice::WriteOnly | QIODevice::Append))
+            m_file->write(chunk);
+    }
+}
+
+void LabelSnapshotStore::waitForFlush()
+{
+    QMutexLocker lock(&m_mutex);
+    while (m_flushing)
+        m_flushDone.wait(&m_mutex);
+}
+
+void LabelSnapshotStore::prune() const
+{
+    const QFileInfoList packs = QDir(m_dir).entryInfoList({ "*.pack" }, QDir::Files, QDir::Name | QDir::Reversed);
+    for (int i = MAX_RUNS; i < packs.size(); ++i)
+        QFile::remove(packs[i].absoluteFilePath());
+}
+
+QList<LabelSnapshotStore::RunInfo> LabelSnapshotStore::runs() const
+{
+    QList<RunInfo> out;
+    if (!isEnabled()) return out;
+
+    const QFileInfoList packs = QDir(m_dir).entryInfoList({ "*.pack" }, QDir::Files, QDir::Name | QDir::Reversed);
+    for (const QFileInfo &fi : packs) {
+        QFile f(fi.absoluteFilePath());
+        if (!f.open(QIODevice::ReadOnly)) continue;
+        RunInfo info;
+        info.packPath = fi.absoluteFilePath();
+        const QJsonObject header = QJsonDocument::fromJson(f.readLine()).object();
+        info.created = QDateTime::fromString(header.value("created").toString(), Qt::ISODateWithMs);
+        while (!f.atEnd())
+            if (f.readLine().endsWith('\n'))
+                ++info.labels;
+        out.append(info);
+    }
+    return out;
+}
+
+int LabelSnapshotStore::restore(const QString &packPath, QString *error)
+{
+    QFile f(packPath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = f.errorString();
+        return -1;
+    }
+
+    int restored = 0;
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine();
+        if (!line.endsWith('\n')) break;           // torn final record
+        const QJsonObject rec  = QJsonDocument::fromJson(line).object();
+        const QString     path = rec.value("path").toString();
+        if (path.isEmpty()) continue;              // header
+
+        if (rec.value("absent").toBool()) {
+            if (QFile::remove(path)) ++restored;
+            continue;
+        }
+        const QByteArray bytes = QByteArray::fromBase64(rec.value("base64").toString().toLatin1());
+        QSaveFile out(path);
+        if (out.open(QIODevice::WriteOnly)
+            && out.write(bytes) >= 0
+            && out.commit())
+            ++restored;
+        else if (error)
+            *error = out.errorString();
+    }
+    return restored;
+}
@@ -0,0 +1,86 @@
+#ifndef LABEL_SNAPSHOT_STORE_H
+#define LABEL_SNAPSHOT_STORE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QWaitCondition>
+#include <memory>
+
+// Copy-on-write snapshots of label files overwritten by an auto-label run.
+// Instead of one .bak copy per label, each run appends the previous contents
+// of the labels it replaces to a single pack file (JSON lines). Records are
+// buffered and written sequentially on the global thread pool, so the
+// labeling thread never waits for the pack. Only the first overwrite of a
+// label in a run is recorded, and labels whose contents would not change
+// (ignoring CRLF vs LF, as labels are written in text mode) are skipped.
+// Previous contents are stored base64-encoded, so restore() puts back the
+// exact bytes of every label of a run, deleting labels the run created.
+class LabelSnapshotStore
+{
+public:
+    struct RunInfo
+    {
+        QString   packPath;
+        QDateTime created;
+        int       labels = 0;
+    };
+
+    // An empty directory disables snapshots.
+    explicit LabelSnapshotStore(const QString &dir = defaultDirectory());
+    ~LabelSnapshotStore();
+
+    LabelSnapshotStore(const LabelSnapshotStore &) = delete;
+    LabelSnapshotStore &operator=(const LabelSnapshotStore &) = delete;
+
+    static QString defaultDirectory();
+
+    // Ends any open run before switching directories.
+    void    setDirectory(const QString &dir);
+    QString directory() const { return m_dir; }
+    bool    isEnabled() const { return !m_dir.isEmpty(); }
+    bool    isInRun() const   { return m_inRun; }
+
+    // The pack file is created lazily on the first snapshot of a run.
+    void beginRun();
+    // Call just before writing newContents (LF line endings) to labelPath.
+    void snapshot(const QString &labelPath, const QByteArray &newContents);
+    // Waits for buffered records, closes the pack and prunes old runs.
+    void endRun();
+
+    QString currentPackPath() const { return m_packPath; }
+    int     snapshotCount() const   { return m_count; }
+
+    // Runs on disk, newest first.
+    QList<RunInfo> runs() const;
+    // Restores the labels recorded in packPath. Returns the number of label
+    // files restored or removed, or -1 if the pack cannot be read.
+    static int restore(const QString &packPath, QString *error = nullptr);
+
+    static constexpr int MAX_RUNS = 20;   // older packs are deleted
+
+private:
+    void append(const QByteArray &record);
+    void flushPending();
+    void waitForFlush();
+    void prune() const;
+
+    QString       m_dir;
+    QString       m_packPath;     // empty until the run's first snapshot
+    QSet<QString> m_seen;         // labels already recorded this run
+    int           m_count = 0;
+    bool          m_inRun = false;
+
+    // Writer state, shared with the flush task on the thread pool
+    QMutex                 m_mutex;
+    QWaitCondition         m_flushDone;
+    QByteArray             m_pending;
+    bool                   m_flushing = false;
+    std::unique_ptr<QFile> m_file;    // only touched by the flush task or when idle
+};
+
+#endif // LABEL_SNAPSHOT_STORE_H
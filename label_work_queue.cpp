@@ -0,0 +1,170 @@
+#include "label_work_queue.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QSysInfo>
+
+LabelWorkQueue::LabelWorkQueue(const QString &datasetDir, const QStringList &images, int blockSize)
+    : m_dir(directoryFor(datasetDir))
+    , m_images(images)
+    , m_blockSize(qMax(1, blockSize))
+    , m_workerId(defaultWorkerId())
+{
+    for (int first = 0; first < m_images.size(); first += m_blockSize) {
+        // File names only, so machines mounting the dataset at different
+        // paths agree on the block names
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        const int last = qMin<int>(first + m_blockSize, m_images.size());
+        for (int i = first; i < last; ++i) {
+            hash.addData(QFileInfo(m_images[i]).fileName().toUtf8());
+            hash.addData(QByteArrayView("\n"));
+        }
+        m_names.append(QString("%1-%2")
+                           .arg(m_names.size(), 6, 10, QChar('0'))
+                           .arg(QString::fromLatin1(hash.result().toHex().left(12))));
+    }
+    // Start workers at different blocks so they rarely race for one claim
+    if (!m_names.isEmpty())
+        m_cursor = int(qHash(m_workerId) % size_t(m_names.size()));
+}
+
+QString LabelWorkQueue::directoryFor(const QString &datasetDir)
+{
+    return datasetDir + "/.yololabel_queue";
+}
+
+QString LabelWorkQueue::defaultWorkerId()
+{
+    return QSysInfo::machineHostName() + ":" + QString::number(QCoreApplication::applicationPid());
+}
+
+QString LabelWorkQueue::claimPath(int index) const
+{
+    return m_dir + "/" + m_names[index] + ".claim";
+}
+
+QString LabelWorkQueue::donePath(int index) const
+{
+    return m_dir + "/" + m_names[index] + ".done";
+}
+
+int LabelWorkQueue::doneCount() const
+{
+    const QStringList files = QDir(m_dir).entryList({ "*.done" }, QDir::Files);
+    const QSet<QString> done(files.begin(), files.end());
+    int n = 0;
+    for (const QString &name : m_names)
+        if (done.contains(name + ".done")) ++n;
+    return n;
+}
+
+LabelWorkQueue::Block LabelWorkQueue::claimNext()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_names.isEmpty() || !QDir().mkpath(m_dir)) return Block();
+
+    // One directory listing per claim instead of a stat per block
+    const QStringList files = QDir(m_dir).entryList(QDir::Files);
+    const QSet<QString> present(files.begin(), files.end());
+
+    const int n = m_names.size();
+    for (int step = 0; step < n; ++step) {
+        const int b = (m_cursor + step) % n;
+        if (present.contains(m_names[b] + ".done")) continue;
+        if (present.contains(m_names[b] + ".claim") && !takeOverExpired(b)) continue;
+        if (!tryClaim(b)) continue;
+
+        m_cursor = (b + 1) % n;
+        Block block;
+        block.index  = b;
+        block.name   = m_names[b];
+        block.images = m_images.mid(b * m_blockSize, m_blockSize);
+        return block;
+    }
+    return Block();
+}
+
+bool LabelWorkQueue::tryClaim(int index)
+{
+    QFile f(claimPath(index));
+    // O_EXCL: exactly one worker succeeds, also over NFSv3 and later
+    if (!f.open(QIODevice::WriteOnly | QIODevice::NewOnly)) return false;
+    f.write(QJsonDocument(QJsonObject{
+                { "worker",  m_workerId },
+                { "claimed", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs) } })
+                .toJson(QJsonDocument::Compact));
+    return true;
+}
+
+// Moves an expired claim out of the way so tryClaim() can create a new one.
+// rename() succeeds for only one of several workers doing this at once.
+bool LabelWorkQueue::takeOverExpired(int index)
+{
+    const QString   path = claimPath(index);
+    const QFileInfo info(path);
+    if (!info.exists()) return true;   // released since the listing
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    if (info.lastModified().toUTC().msecsTo(now) < m_leaseMs) return false;
+
+    QString stale = path + ".stale-" + m_workerId;
+    stale.replace(':', '_');
+    if (!QFile::rename(path, stale)) return false;
+
+    // Another worker may have replaced the claim between our check and the
+    // rename; if what we moved is fresh, put it back.
+    if (QFileInfo(stale).lastModified().toUTC().msecsTo(now) < m_leaseMs) {
+        if (!QFile::rename(stale, path)) QFile::remove(stale);
+        return false;
+    }
+    QFile::remove(stale);
+    return true;
+}
+
+bool LabelWorkQueue::ownsClaim(int index) const
+{
+    QFile f(claimPath(index));
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    return QJsonDocument::fromJson(f.readAll()).object().value("worker").toString() == m_workerId;
+}
+
+bool LabelWorkQueue::renew(const Block &block)
+{
+    if (!block.isValid() || !ownsClaim(block.index)) return false;
+    QFile f(claimPath(block.index));
+    return f.open(QIODevice::ReadWrite)
+        && f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+}
+
+bool LabelWorkQueue::markDone(const Block &block)
+{
+    if (!block.isValid()) return false;
+
+    QJsonArray images;
+    for (const QString &path : block.images)
+        images.append(QFileInfo(path).fileName());
+    QSaveFile out(donePath(block.index));
+    const bool ok = out.open(QIODevice::WriteOnly)
+        && out.write(QJsonDocument(QJsonObject{
+                         { "worker",   m_workerId },
+                         { "finished", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs) },
+                         { "images",   images } })
+                         .toJson(QJsonDocument::Compact)) >= 0
+        && out.commit();
+    release(block);
+    return ok;
+}
+
+void LabelWorkQueue::release(const Block &block)
+{
+    if (block.isValid() && ownsClaim(block.index))
+        QFile::remove(claimPath(block.index));
+}
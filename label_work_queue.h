@@ -0,0 +1,88 @@
+#ifndef LABEL_WORK_QUEUE_H
+#define LABEL_WORK_QUEUE_H
+
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+// A work queue for auto-labeling one dataset from several processes or
+// machines at once, kept entirely in files next to the images (e.g. on NFS),
+// so no coordinating service is needed. The image list is cut into blocks;
+// a worker claims a block by creating "<block>.claim" with O_EXCL
+// (QIODevice::NewOnly), labels it, then writes "<block>.done". While
+// working it renews the claim's modification time; a claim not renewed for
+// leaseMs is considered abandoned (crashed worker) and may be taken over.
+//
+// Block names include a hash of the block's file names, so every worker
+// that lists the same directory agrees on them, and a changed dataset does
+// not reuse stale markers. In the rare race where two workers take over the
+// same expired claim, a block is labeled twice; label writes are atomic, so
+// this costs time but never corrupts a label.
+//
+// Clocks on the participating machines must agree to well within leaseMs.
+class LabelWorkQueue
+{
+public:
+    struct Block
+    {
+        int         index = -1;
+        QString     name;       // file stem in the queue directory
+        QStringList images;
+        bool isValid() const { return index >= 0; }
+    };
+
+    static constexpr int    DEFAULT_BLOCK_SIZE = 32;
+    static constexpr qint64 DEFAULT_LEASE_MS   = 5 * 60 * 1000;
+
+    // images must be in the same order for every worker (the natural sort
+    // used by the GUI and yololabel-cli).
+    LabelWorkQueue(const QString &datasetDir, const QStringList &images,
+                   int blockSize = DEFAULT_BLOCK_SIZE);
+
+    LabelWorkQueue(const LabelWorkQueue &) = delete;
+    LabelWorkQueue &operator=(const LabelWorkQueue &) = delete;
+
+    static QString directoryFor(const QString &datasetDir);
+    // "<host>:<pid>"; threads of one process share it.
+    static QString defaultWorkerId();
+
+    void    setWorkerId(const QString &id) { m_workerId = id; }
+    QString workerId() const               { return m_workerId; }
+    void    setLeaseMs(qint64 ms)          { m_leaseMs = qMax<qint64>(1000, ms); }
+    qint64  leaseMs() const                { return m_leaseMs; }
+    // Renew claims at least this often.
+    qint64  renewIntervalMs() const        { return m_leaseMs / 4; }
+
+    QString directory() const  { return m_dir; }
+    int     blockCount() const { return m_names.size(); }
+    // Blocks finished by any worker.
+    int     doneCount() const;
+
+    // Claims the next free or expired block; an invalid Block when every
+    // block is done or claimed by a live worker. Thread-safe.
+    Block claimNext();
+    // Refreshes the lease. Returns false if the claim was lost to another
+    // worker (the block may be finished anyway).
+    bool  renew(const Block &block);
+    bool  markDone(const Block &block);
+    // Gives a block back unfinished, e.g. on cancel.
+    void  release(const Block &block);
+
+private:
+    QString claimPath(int index) const;
+    QString donePath(int index) const;
+    bool    tryClaim(int index);
+    bool    takeOverExpired(int index);
+    bool    ownsClaim(int index) const;
+
+    QString     m_dir;
+    QStringList m_images;
+    int         m_blockSize;
+    QStringList m_names;        // per block
+    QString     m_workerId;
+    qint64      m_leaseMs = DEFAULT_LEASE_MS;
+    int         m_cursor  = 0;  // next block to try
+    QMutex      m_mutex;
+};
+
+#endif // LABEL_WORK_QUEUE_H
@@ -1,5 +1,9 @@
 #include "mainwindow.h"
+#include "trace.h"
 #include <QApplication>
+#ifdef YOLOLABEL_TRACE
+#include <cstdio>
+#endif
 
 int main(int argc, char *argv[])
 {
@@ -7,7 +11,11 @@ int main(int argc, char *argv[])
     MainWindow w;
     w.set_args(argc, argv);
     w.show();
-    return a.exec();
+    const int ret = a.exec();
+#ifdef YOLOLABEL_TRACE
+    const QString tracePath = Trace::defaultPath();
+    if (Trace::writeJson(tracePath))
+        std::fprintf(stderr, "Trace written to %s\n", qPrintable(tracePath));
+#endif
+    return ret;
 }
-
-
@@ -1,5 +1,7 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "image_cache.h"
+#include "trace.h"
 
 #include <QDir>
 #include <QFileDialog>
@@ -7,15 +9,18 @@
 #include <QKeyEvent>
 #include <QShortcut>
 #include <QCollator>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QHBoxLayout>
+#include <QLocale>
 #include <QSettings>
 #include <QVBoxLayout>
 #ifdef ONNXRUNTIME_AVAILABLE
 #include <QProgressDialog>
 #endif
 #include <iomanip>
+#include <sstream>
 #include <cmath>
 
 using std::ofstream;
@@ -120,6 +125,17 @@ MainWindow::MainWindow(QWidget *parent) :
     m_btnAutoLabelAll->setStyleSheet(btnStyle);
     m_btnAutoLabelAll->setEnabled(false);
 
+    m_checkSharedQueue = new QCheckBox("Shared queue", this);
+    m_checkSharedQueue->setToolTip(
+        "Auto Label All claims blocks of images from a work queue in the dataset "
+        "folder, so other YoloLabel or yololabel-cli instances can label the same "
+        "dataset at the same time");
+    m_checkSharedQueue->setStyleSheet(ui->checkBox_visualize_class_name->styleSheet());
+    m_checkSharedQueue->setChecked(QSettings("YoloLabel", "Session").value("sharedQueue", false).toBool());
+    connect(m_checkSharedQueue, &QCheckBox::toggled, this, [](bool checked) {
+        QSettings("YoloLabel", "Session").setValue("sharedQueue", checked);
+    });
+
     m_labelModelStatus = new QLabel("No model loaded", this);
     m_labelModelStatus->setStyleSheet(labelStyle);
 
@@ -130,6 +146,7 @@ MainWindow::MainWindow(QWidget *parent) :
     autoLabelLayout->addWidget(m_labelConfidence);
     autoLabelLayout->addWidget(m_btnAutoLabel);
     autoLabelLayout->addWidget(m_btnAutoLabelAll);
+    autoLabelLayout->addWidget(m_checkSharedQueue);
     autoLabelLayout->addWidget(m_labelModelStatus, 1);
 
     ui->gridLayout->addLayout(autoLabelLayout, 1, 0);
@@ -142,32 +159,52 @@ MainWindow::MainWindow(QWidget *parent) :
 #endif
 
     // ── Cloud auto-label setup ─────────────────────────────────────────
+    int cloudChunksInFlight, cloudUploadMaxSide, cloudUploadQuality;
+    QString cloudUploadFormat;
     {
         QSettings s("YoloLabel", "CloudAI");
         m_cloudApiKey = s.value("apiKey",  "").toString();
         m_cloudPrompt = s.value("prompt",  "").toString();
+        cloudChunksInFlight = s.value("chunksInFlight", 2).toInt();
+        cloudUploadMaxSide  = s.value("uploadMaxSide", 1024).toInt();
+        cloudUploadQuality  = s.value("uploadQuality", 90).toInt();
+        cloudUploadFormat   = s.value("uploadFormat", "jpg").toString();
+#ifdef ONNXRUNTIME_AVAILABLE
+        m_routingThresholds.minTopConfidence = s.value("routeMinConfidence", 0.5).toFloat();
+        m_routingThresholds.minDetections    = s.value("routeMinDetections", 1).toInt();
+        m_routingThresholds.maxDisagreement  = s.value("routeMaxDisagreement", 0.25).toFloat();
+#endif
     }
 
     m_cloudLabeler = new CloudAutoLabeler(this);
     m_cloudLabeler->setApiKey(m_cloudApiKey);
     m_cloudLabeler->setPrompt(m_cloudPrompt);
+    m_cloudLabeler->setMaxChunksInFlight(cloudChunksInFlight);
+    m_cloudLabeler->setUploadPreparation(cloudUploadMaxSide, cloudUploadQuality, cloudUploadFormat);
 
     connect(m_cloudLabeler, &CloudAutoLabeler::busyChanged, this, [this](bool busy) {
-        // Disable image slider while a batch is running to prevent navigation
-        ui->horizontalSlider_images->setEnabled(!busy);
-        if (!busy) resetCloudButtons();
+        // Navigation stays enabled during a run; goto_img() moves the image
+        // on screen to the front of the cloud queue.
+        if (busy) prioritizeCloudImages();
+        else      resetCloudButtons();
     });
     connect(m_cloudLabeler, &CloudAutoLabeler::progress, this, [this](int done, int total) {
         m_btnCloudAutoLabelAll->setText(
             QString("\u2601 Auto Label All (%1/%2)\u2026").arg(done).arg(total));
     });
+    // A label that arrives for the image on screen is shown unless the user
+    // has started editing it; their edits win and are saved on navigation.
     connect(m_cloudLabeler, &CloudAutoLabeler::labelReady, this,
             [this](const QString &imagePath, int /*n*/, int /*ms*/) {
-        if (imagePath == m_imgList.value(m_imgIndex))
+        if (imagePath != m_imgList.value(m_imgIndex)) return;
+        if (ui->label_image->isModified())
+            statusBar()->showMessage("Cloud label for this image arrived; keeping your edits.", 4000);
+        else
             goto_img(m_imgIndex);
     });
     connect(m_cloudLabeler, &CloudAutoLabeler::finished, this, [this](int) {
-        goto_img(m_imgIndex);
+        if (!ui->label_image->isModified())
+            goto_img(m_imgIndex);
     });
     connect(m_cloudLabeler, &CloudAutoLabeler::errorOccurred, this, [this](const QString &msg) {
         QMessageBox::warning(this, "Auto Label", msg);
@@ -205,12 +242,27 @@ MainWindow::MainWindow(QWidget *parent) :
     m_btnCancelAutoLabel->setVisible(false);
     connect(m_btnCancelAutoLabel, &QPushButton::clicked, this, &MainWindow::cancelAutoLabel);
 
+#ifdef ONNXRUNTIME_AVAILABLE
+    m_checkLocalFirst = new QCheckBox("Local first", this);
+    m_checkLocalFirst->setToolTip(
+        "Auto Label All AI labels every image with the loaded model first and "
+        "only sends low-confidence images to the cloud");
+    m_checkLocalFirst->setStyleSheet(ui->checkBox_visualize_class_name->styleSheet());
+    m_checkLocalFirst->setChecked(QSettings("YoloLabel", "CloudAI").value("localFirst", false).toBool());
+    connect(m_checkLocalFirst, &QCheckBox::toggled, this, [](bool checked) {
+        QSettings("YoloLabel", "CloudAI").setValue("localFirst", checked);
+    });
+#endif
+
     {
         QHBoxLayout *cloudLayout = new QHBoxLayout();
         cloudLayout->setContentsMargins(0, 2, 0, 2);
         cloudLayout->addWidget(m_btnCloudAutoLabel);
         cloudLayout->addWidget(m_btnCloudAutoLabelAll);
         cloudLayout->addWidget(m_btnCancelAutoLabel);
+#ifdef ONNXRUNTIME_AVAILABLE
+        cloudLayout->addWidget(m_checkLocalFirst);
+#endif
         cloudLayout->addStretch();
         // Insert below the ONNX auto-label row (or at row 1 if ONNX is not built)
         int cloudRow = ui->gridLayout->rowCount();
@@ -222,7 +274,21 @@ MainWindow::MainWindow(QWidget *parent) :
 
     init_table_widget();
 
+#ifdef YOLOLABEL_TRACE
+    // Dump the trace so far without quitting; another dump is written at exit
+    connect(new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_T), this),
+            &QShortcut::activated, this, [this]() {
+        const QString path = Trace::defaultPath();
+        QString error;
+        if (Trace::writeJson(path, &error))
+            statusBar()->showMessage("Trace written to " + path, 5000);
+        else
+            statusBar()->showMessage("Cannot write trace: " + error, 5000);
+    });
+#endif
+
     QTimer::singleShot(0, this, &MainWindow::restoreLastSession);
+    QTimer::singleShot(0, this, &MainWindow::offerCloudResume);
 }
 
 MainWindow::~MainWindow()
@@ -375,6 +441,7 @@ void MainWindow::set_focused_file(const int fileIndex)
 
 void MainWindow::goto_img(const int fileIndex)
 {
+    TRACE_SCOPE("MainWindow", "goto_img");
     if (m_imgList.isEmpty() || fileIndex < 0 || fileIndex >= m_imgList.size()) return;
 
     m_imgIndex = fileIndex;
@@ -390,6 +457,14 @@ void MainWindow::goto_img(const int fileIndex)
     set_label_progress(m_imgIndex);
     set_focused_file(m_imgIndex);
 
+    // Decode the neighbours in the background so A/D navigation hits the cache
+    if (m_imgIndex + 1 < m_imgList.size())
+        ImageCache::instance().prefetch(m_imgList.at(m_imgIndex + 1));
+    if (m_imgIndex > 0)
+        ImageCache::instance().prefetch(m_imgList.at(m_imgIndex - 1));
+
+    prioritizeCloudImages();
+
     //it blocks crash with slider change
     ui->horizontalSlider_images->blockSignals(true);
     ui->horizontalSlider_images->setValue(m_imgIndex);
@@ -398,22 +473,25 @@ void MainWindow::goto_img(const int fileIndex)
 
 void MainWindow::next_img(bool bSavePrev)
 {
-    if (m_cloudLabeler && m_cloudLabeler->isBusy()) return;
-    if(bSavePrev && ui->label_image->isOpened()) save_label_data();
+    if(bSavePrev) saveBeforeLeavingImage();
     goto_img(m_imgIndex + 1);
 }
 
 void MainWindow::prev_img(bool bSavePrev)
 {
-    if (m_cloudLabeler && m_cloudLabeler->isBusy()) return;
-    if(bSavePrev && ui->label_image->isOpened()) save_label_data();
+    if(bSavePrev) saveBeforeLeavingImage();
     goto_img(m_imgIndex - 1);
 }
 
 void MainWindow::save_label_data()
 {
+    TRACE_SCOPE("MainWindow", "save_label_data");
     if(m_imgList.size() == 0) return;
 
+    // A label saved by hand during a cloud run is not overwritten by the run
+    if (m_cloudLabeler && m_cloudLabeler->isBusy())
+        m_cloudLabeler->keepUserLabel(m_imgList.at(m_imgIndex));
+
     QString qstrOutputLabelData = get_labeling_data(m_imgList.at(m_imgIndex));
     ofstream fileOutputLabelData(qPrintable(qstrOutputLabelData));
 
@@ -446,7 +524,7 @@ void MainWindow::save_label_data()
 void MainWindow::clear_label_data()
 {
     ui->label_image->clearAllBoxes();
-    ui->label_image->showImage();
+    ui->label_image->requestRepaint();
 }
 
 void MainWindow::remove_img()
@@ -567,6 +645,7 @@ void MainWindow::pjreddie_style_msgBox(QMessageBox::Icon icon, QString title, QS
 
 bool MainWindow::get_files(QString imgDir)
 {
+    TRACE_SCOPE("MainWindow", "get_files");
     bool value = false;
     QDir dir(imgDir);
     QCollator collator;
@@ -817,19 +896,19 @@ void MainWindow::paste_annotations()
     if(m_copiedAnnotations.isEmpty() || !ui->label_image->isOpened()) return;
     ui->label_image->saveState();
     ui->label_image->m_objBoundingBoxes = m_copiedAnnotations;
-    ui->label_image->showImage();
+    ui->label_image->requestRepaint();
 }
 
 void MainWindow::undo()
 {
     if(ui->label_image->undo())
-        ui->label_image->showImage();
+        ui->label_image->requestRepaint();
 }
 
 void MainWindow::redo()
 {
     if(ui->label_image->redo())
-        ui->label_image->showImage();
+        ui->label_image->requestRepaint();
 }
 
 void MainWindow::on_usageTimer_timeout()
@@ -897,13 +976,15 @@ void MainWindow::loadOnnxModel(const QString& modelPath)
         }
         if (m_detector.isEndToEnd()) versionStr += " (end2end)";
 
-        m_labelModelStatus->setText(
+        m_modelStatusText =
             QString("%1 | %2 classes | %3x%4 | %5")
                 .arg(QFileInfo(modelPath).fileName())
                 .arg(m_detector.getNumClasses())
                 .arg(m_detector.getInputWidth())
                 .arg(m_detector.getInputHeight())
-                .arg(versionStr));
+                .arg(versionStr);
+        m_labelModelStatus->setText(m_modelStatusText);
+        m_labelModelStatus->setToolTip(QString());
 
         // Class list handling
         const auto& modelClasses = m_detector.getClassNames();
@@ -936,7 +1017,8 @@ void MainWindow::loadOnnxModel(const QString& modelPath)
                         .arg(modelClasses.size()));
                 m_btnAutoLabel->setEnabled(false);
                 m_btnAutoLabelAll->setEnabled(false);
-                m_labelModelStatus->setText(m_labelModelStatus->text() + " | CLASS MISMATCH");
+                m_modelStatusText += " | CLASS MISMATCH";
+                m_labelModelStatus->setText(m_modelStatusText);
                 return;
             }
         }
@@ -948,6 +1030,7 @@ void MainWindow::loadOnnxModel(const QString& modelPath)
         pjreddie_style_msgBox(QMessageBox::Critical, "Error",
             QString("Failed to load model:\n%1").arg(QString::fromStdString(errorMsg)));
         m_labelModelStatus->setText("Load failed");
+        m_labelModelStatus->setToolTip(QString());
     }
 }
 
@@ -992,6 +1075,7 @@ void MainWindow::loadClassesFromModel()
 
 void MainWindow::on_autoLabel_clicked()
 {
+    TRACE_SCOPE("MainWindow", "autoLabel");
     if (!m_detector.isLoaded() || !ui->label_image->isOpened()) return;
 
     QImage img = ui->label_image->getInputImage();
@@ -1000,6 +1084,7 @@ void MainWindow::on_autoLabel_clicked()
     QApplication::setOverrideCursor(Qt::WaitCursor);
     auto detections = m_detector.detect(img, getConfidenceThreshold());
     QApplication::restoreOverrideCursor();
+    showDetectorTimings(false);
 
     if (detections.empty()) {
         pjreddie_style_msgBox(QMessageBox::Information, "Auto Label",
@@ -1012,8 +1097,14 @@ void MainWindow::on_autoLabel_clicked()
 
 void MainWindow::on_autoLabelAll_clicked()
 {
+    TRACE_SCOPE("MainWindow", "autoLabelAll");
     if (!m_detector.isLoaded() || m_imgList.isEmpty()) return;
 
+    if (m_checkSharedQueue->isChecked()) {
+        autoLabelAllFromQueue();
+        return;
+    }
+
     QMessageBox msgBox(QMessageBox::Question, "Auto Label All",
         QString("Auto-label all %1 images?\nExisting labels will be overwritten.")
             .arg(m_imgList.size()),
@@ -1028,35 +1119,20 @@ void MainWindow::on_autoLabelAll_clicked()
     progress.setStyleSheet("QProgressDialog { background-color: rgb(34, 0, 85); color: rgb(0, 255, 0); }");
 
     int labeled = 0;
-    int maxClassIdx = m_objList.size() - 1;
 
     for (int i = 0; i < m_imgList.size(); ++i) {
         progress.setValue(i);
         if (progress.wasCanceled()) break;
 
-        QImage img(m_imgList.at(i));
+        QImage img = loadDetectorInput(m_imgList.at(i));
         if (img.isNull()) continue;
 
         auto detections = m_detector.detect(img, getConfidenceThreshold());
-
-        QString labelPath = get_labeling_data(m_imgList.at(i));
-        ofstream out(qPrintable(labelPath));
-        if (!out.is_open()) continue;
-
-        for (const auto& det : detections) {
-            if (det.classId < 0 || det.classId > maxClassIdx) continue;
-            double cx = det.x + det.width / 2.0;
-            double cy = det.y + det.height / 2.0;
-            out << det.classId << " "
-                << std::fixed << std::setprecision(6) << cx << " "
-                << std::fixed << std::setprecision(6) << cy << " "
-                << std::fixed << std::setprecision(6) << static_cast<double>(det.width) << " "
-                << std::fixed << std::setprecision(6) << static_cast<double>(det.height) << "\n";
-        }
-        out.close();
-        labeled++;
+        if (writeDetectionLabels(m_imgList.at(i), detections))
+            labeled++;
     }
     progress.setValue(m_imgList.size());
+    showDetectorTimings(true);
 
     goto_img(m_imgIndex);
 
@@ -1064,6 +1140,212 @@ void MainWindow::on_autoLabelAll_clicked()
         QString("Auto-labeled %1 of %2 images.").arg(labeled).arg(m_imgList.size()));
 }
 
+// Auto Label All as one worker of a LabelWorkQueue in the dataset folder.
+// Other instances (GUI or yololabel-cli) labeling the same folder take the
+// remaining blocks; blocks of crashed instances are picked up once their
+// claims expire.
+void MainWindow::autoLabelAllFromQueue()
+{
+    TRACE_SCOPE("MainWindow", "autoLabelAllFromQueue");
+    QMessageBox msgBox(QMessageBox::Question, "Auto Label All",
+        QString("Auto-label %1 images together with other workers on this folder?\n"
+                "Existing labels will be overwritten.")
+            .arg(m_imgList.size()),
+        QMessageBox::Yes | QMessageBox::No);
+    msgBox.setStyleSheet("background-color: rgb(34, 0, 85); color: rgb(0, 255, 0);");
+    if (msgBox.exec() != QMessageBox::Yes) return;
+
+    save_label_data();
+
+    LabelWorkQueue queue(m_imgDir, m_imgList);
+
+    QProgressDialog progress("Auto-labeling images (shared queue)...", "Cancel",
+                             0, queue.blockCount(), this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setStyleSheet("QProgressDialog { background-color: rgb(34, 0, 85); color: rgb(0, 255, 0); }");
+    progress.setValue(queue.doneCount());
+
+    int labeled = 0, blocks = 0;
+    bool canceled = false;
+
+    while (!canceled) {
+        const LabelWorkQueue::Block block = queue.claimNext();
+        if (!block.isValid()) break;
+
+        QElapsedTimer sinceRenew;
+        sinceRenew.start();
+        for (const QString& path : block.images) {
+            QApplication::processEvents();
+            if (progress.wasCanceled()) {
+                canceled = true;
+                break;
+            }
+
+            QImage img = loadDetectorInput(path);
+            if (img.isNull()) continue;
+            auto detections = m_detector.detect(img, getConfidenceThreshold());
+            if (writeDetectionLabels(path, detections))
+                labeled++;
+
+            if (sinceRenew.elapsed() >= queue.renewIntervalMs()) {
+                queue.renew(block);
+                sinceRenew.restart();
+            }
+        }
+
+        if (canceled) {
+            queue.release(block);
+        } else if (queue.markDone(block)) {
+            blocks++;
+        }
+        progress.setValue(queue.doneCount());
+    }
+    progress.setValue(progress.maximum());
+    showDetectorTimings(true);
+
+    goto_img(m_imgIndex);
+
+    const int done = queue.doneCount();
+    pjreddie_style_msgBox(QMessageBox::Information, "Auto Label All",
+        QString("Auto-labeled %1 images in %2 blocks.\n"
+                "%3 of %4 blocks are done across all workers.")
+            .arg(labeled).arg(blocks).arg(done).arg(queue.blockCount()));
+}
+
+static QString formatStageMs(double ms)
+{
+    return QString::number(ms, 'f', ms < 10.0 ? 1 : 0) + "ms";
+}
+
+static QString formatStageTimes(const DetectorStageTimes& t)
+{
+    QString text = QString("pre %1 | run %2 | post %3")
+        .arg(formatStageMs(t.preprocessMs), formatStageMs(t.runMs), formatStageMs(t.postprocessMs));
+    if (t.nmsMs > 0.0)
+        text += " | nms " + formatStageMs(t.nmsMs);
+    return text;
+}
+
+// Appends detector stage timings to the model status: the last call after a
+// single image, the median of recent calls after a batch. The tooltip has
+// the p50/p99 breakdown and candidate counts.
+void MainWindow::showDetectorTimings(bool batch)
+{
+    const DetectorStats& stats = m_detector.getStats();
+    if (stats.isEmpty()) return;
+
+    const DetectorStageTimes shown = batch ? stats.percentile(0.5) : stats.last();
+    m_labelModelStatus->setText(m_modelStatusText + " | " + formatStageTimes(shown));
+
+    const DetectorStageTimes p50 = stats.percentile(0.5);
+    const DetectorStageTimes p99 = stats.percentile(0.99);
+    m_labelModelStatus->setToolTip(
+        QString("Last %1 inferences\n"
+                "p50: %2\n"
+                "p99: %3\n"
+                "candidates before NMS: p50 %4, p99 %5\n"
+                "boxes kept: p50 %6, p99 %7")
+            .arg(std::min<quint64>(stats.calls(), DetectorStats::WINDOW))
+            .arg(formatStageTimes(p50), formatStageTimes(p99))
+            .arg(p50.candidates).arg(p99.candidates)
+            .arg(p50.kept).arg(p99.kept));
+}
+
+// Reuses a full decode if one is cached, otherwise decodes near model size.
+QImage MainWindow::loadDetectorInput(const QString& imagePath)
+{
+    QImage img = ImageCache::instance().peek(imagePath);
+    if (img.isNull())
+        img = m_detector.loadInputImage(imagePath);
+    return img;
+}
+
+bool MainWindow::writeDetectionLabels(const QString& imagePath,
+                                      const std::vector<DetectionResult>& detections)
+{
+    TRACE_SCOPE("MainWindow", "writeDetectionLabels");
+    QString labelPath = get_labeling_data(imagePath);
+    std::ostringstream out;
+
+    int maxClassIdx = m_objList.size() - 1;
+    for (const auto& det : detections) {
+        if (det.classId < 0 || det.classId > maxClassIdx) continue;
+        double cx = det.x + det.width / 2.0;
+        double cy = det.y + det.height / 2.0;
+        out << det.classId << " "
+            << std::fixed << std::setprecision(6) << cx << " "
+            << std::fixed << std::setprecision(6) << cy << " "
+            << std::fixed << std::setprecision(6) << static_cast<double>(det.width) << " "
+            << std::fixed << std::setprecision(6) << static_cast<double>(det.height) << "\n";
+    }
+    const std::string text = out.str();
+
+    // Part of a cloud run's snapshot when routing local-first; a no-op otherwise
+    m_cloudLabeler->snapshotLabel(labelPath, QByteArray::fromStdString(text));
+    ofstream file(qPrintable(labelPath));
+    if (!file.is_open()) return false;
+    file << text;
+    file.close();
+    return true;
+}
+
+// Local labels are only trusted when the model's classes match the class
+// list, which is exactly when the local "Auto Label All" button is enabled.
+bool MainWindow::canRouteLocalFirst() const
+{
+    return m_detector.isLoaded() && m_btnAutoLabelAll->isEnabled();
+}
+
+// Runs the local model over every image. Confident results are written as
+// labels right away; images the model is unsure about are returned in
+// cloudPaths. Returns false if the user cancels.
+bool MainWindow::routeLocalFirst(QStringList& cloudPaths)
+{
+    TRACE_SCOPE("MainWindow", "routeLocalFirst");
+    cloudPaths.clear();
+
+    QProgressDialog progress("Labeling locally before cloud...", "Cancel", 0, m_imgList.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setStyleSheet("QProgressDialog { background-color: rgb(34, 0, 85); color: rgb(0, 255, 0); }");
+
+    int local = 0, lowConfidence = 0, fewDetections = 0, disagreement = 0;
+
+    for (int i = 0; i < m_imgList.size(); ++i) {
+        progress.setValue(i);
+        if (progress.wasCanceled()) return false;
+
+        const QString& path = m_imgList.at(i);
+        QImage img = loadDetectorInput(path);
+        if (img.isNull()) {
+            cloudPaths.append(path);
+            continue;
+        }
+
+        auto detections = m_detector.detect(img, getConfidenceThreshold());
+        switch (HybridRouter::route(detections, m_routingThresholds)) {
+        case HybridRouter::Decision::Local:
+            if (writeDetectionLabels(path, detections)) {
+                local++;
+                continue;
+            }
+            break;
+        case HybridRouter::Decision::LowConfidence: lowConfidence++; break;
+        case HybridRouter::Decision::FewDetections: fewDetections++; break;
+        case HybridRouter::Decision::Disagreement:  disagreement++;  break;
+        }
+        cloudPaths.append(path);
+    }
+    progress.setValue(m_imgList.size());
+    showDetectorTimings(true);
+
+    statusBar()->showMessage(
+        QString("Labeled %1 images locally; sending %2 to cloud "
+                "(%3 low confidence, %4 few detections, %5 class disagreement).")
+            .arg(local).arg(cloudPaths.size())
+            .arg(lowConfidence).arg(fewDetections).arg(disagreement), 8000);
+    return true;
+}
+
 void MainWindow::on_confidenceSlider_changed(int value)
 {
     m_labelConfidence->setText(QString("Conf: %1%").arg(value));
@@ -1186,12 +1468,18 @@ void MainWindow::initSideTabWidget()
     connect(saveBtn,  &QPushButton::clicked, this, &MainWindow::saveAiSettings);
     connect(clearBtn, &QPushButton::clicked, this, [this](){ m_settingsKeyEdit->clear(); saveAiSettings(); });
 
+    auto *restoreBtn = new QPushButton("Undo Last Run", aiTab);
+    restoreBtn->setStyleSheet(btnStyle);
+    restoreBtn->setToolTip("Restore the label files overwritten by the most recent cloud auto-label run");
+    connect(restoreBtn, &QPushButton::clicked, this, &MainWindow::restoreLastCloudRun);
+
     aiLayout->addWidget(keyLabel);
     aiLayout->addLayout(keyRow);
     aiLayout->addWidget(promptLabel);
     aiLayout->addWidget(m_settingsPromptEdit);
     aiLayout->addWidget(hintLabel);
     aiLayout->addLayout(btnRow);
+    aiLayout->addWidget(restoreBtn, 0, Qt::AlignLeft);
     aiLayout->addStretch();
 
     // ── Assemble tab widget ──────────────────────────────────────────
@@ -1232,6 +1520,12 @@ void MainWindow::saveAiSettings()
     m_cloudLabeler->setPrompt(m_cloudPrompt);
 
     statusBar()->showMessage("AI settings saved.", 2000);
+
+    // A resume accepted before the key was entered starts now
+    if (m_cloudResumePending && !m_cloudApiKey.isEmpty()) {
+        m_cloudResumePending = false;
+        resumeCloudBatch();
+    }
 }
 
 void MainWindow::resetCloudButtons()
@@ -1248,6 +1542,107 @@ void MainWindow::cancelAutoLabel()
     m_cloudLabeler->cancel();
 }
 
+// During a cloud run, labels the image on screen and the next few first so
+// they can be reviewed while the rest of the dataset is still processing.
+void MainWindow::prioritizeCloudImages()
+{
+    if (!m_cloudLabeler || !m_cloudLabeler->isBusy() || m_imgList.isEmpty()) return;
+
+    constexpr int lookahead = 3;
+    QStringList paths;
+    for (int i = m_imgIndex; i < m_imgList.size() && i <= m_imgIndex + lookahead; ++i)
+        paths.append(m_imgList.at(i));
+    m_cloudLabeler->prioritize(paths);
+}
+
+// Saves the image on screen before navigating away. During a cloud run an
+// unedited view may be older than the label the run just wrote for it, so
+// only images the user edited are saved.
+void MainWindow::saveBeforeLeavingImage()
+{
+    if (!ui->label_image->isOpened()) return;
+    if (m_cloudLabeler && m_cloudLabeler->isBusy() && !ui->label_image->isModified()) return;
+    save_label_data();
+}
+
+// Offers to continue a cloud batch that was interrupted by a crash or restart.
+void MainWindow::offerCloudResume()
+{
+    if (m_cloudLabeler->isBusy()) return;
+    const CloudBatchJournal::State state = m_cloudLabeler->resumableBatch();
+    if (!state.isValid()) return;
+
+    const int left = state.remaining().size();
+    QMessageBox msgBox(QMessageBox::Question, "Resume Auto Label All",
+        QString("A cloud auto-label run was interrupted with %1 of %2 images left.\n"
+                "Resume it now?").arg(left).arg(state.paths.size()),
+        QMessageBox::Yes | QMessageBox::No, this);
+    if (msgBox.exec() != QMessageBox::Yes) {
+        m_cloudLabeler->discardResumableBatch();
+        return;
+    }
+
+    if (m_cloudApiKey.isEmpty()) {
+        m_cloudResumePending = true;
+        m_sideTabWidget->setCurrentIndex(1);
+        syncAiSettingsTab();
+        statusBar()->showMessage("Enter your API key in the AI Settings tab to resume.", 4000);
+        return;
+    }
+    resumeCloudBatch();
+}
+
+// Continues the journaled run once the user has agreed and a key is set.
+void MainWindow::resumeCloudBatch()
+{
+    if (m_cloudLabeler->isBusy()) return;
+    const CloudBatchJournal::State state = m_cloudLabeler->resumableBatch();
+    if (!state.isValid()) return;
+
+    const int left = state.remaining().size();
+    m_btnCloudAutoLabel->setEnabled(false);
+    m_btnCloudAutoLabelAll->setEnabled(false);
+    m_btnCancelAutoLabel->setVisible(true);
+    m_btnCloudAutoLabelAll->setText(
+        QString("\u2601 Auto Label All (%1/%2)\u2026")
+            .arg(state.paths.size() - left).arg(state.paths.size()));
+
+    m_cloudLabeler->setApiKey(m_cloudApiKey);
+    m_cloudLabeler->resumeBatch();
+}
+
+// Puts back the labels overwritten by the newest cloud run, from its snapshot
+// pack. The pack is removed afterwards, so repeated clicks step back one run
+// at a time.
+void MainWindow::restoreLastCloudRun()
+{
+    if (m_cloudLabeler->isBusy()) return;
+    const QList<LabelSnapshotStore::RunInfo> runs = m_cloudLabeler->snapshotRuns();
+    if (runs.isEmpty()) {
+        statusBar()->showMessage("No cloud auto-label run to undo.", 3000);
+        return;
+    }
+
+    const LabelSnapshotStore::RunInfo &run = runs.first();
+    QMessageBox msgBox(QMessageBox::Question, "Undo Last Run",
+        QString("Restore %1 label file(s) to how they were before the cloud "
+                "auto-label run of %2?")
+            .arg(run.labels).arg(QLocale().toString(run.created, QLocale::ShortFormat)),
+        QMessageBox::Yes | QMessageBox::No, this);
+    if (msgBox.exec() != QMessageBox::Yes) return;
+
+    QString error;
+    const int restored = LabelSnapshotStore::restore(run.packPath, &error);
+    if (restored < 0 || !error.isEmpty()) {
+        QMessageBox::warning(this, "Undo Last Run",
+            QString("Some labels could not be restored:\n%1").arg(error));
+    } else {
+        QFile::remove(run.packPath);
+        statusBar()->showMessage(QString("Restored %1 label file(s).").arg(restored), 4000);
+    }
+    goto_img(m_imgIndex);
+}
+
 // ── Cloud auto-label ────────────────────────────────────────────────────────
 
 bool MainWindow::checkUploadConsent()
@@ -1282,7 +1677,6 @@ void MainWindow::submitCloudJob()
     if (!checkUploadConsent()) return;
 
     save_label_data();  // preserve current manual annotations before overwriting
-    ui->label_image->saveState(); // enable Ctrl+Z undo after cloud labels are applied
 
     m_btnCloudAutoLabel->setEnabled(false);
     m_btnCloudAutoLabelAll->setEnabled(false);
@@ -1326,15 +1720,40 @@ void MainWindow::cloudAutoLabelAll()
 
     save_label_data();
 
+    QStringList cloudPaths = m_imgList;
+#ifdef ONNXRUNTIME_AVAILABLE
+    if (m_checkLocalFirst->isChecked()) {
+        if (!canRouteLocalFirst()) {
+            statusBar()->showMessage(
+                "Local first needs a loaded model matching the class list; "
+                "sending all images to cloud.", 5000);
+        } else {
+            // Local labels go into the same snapshot as the cloud ones, so
+            // Undo Last Run reverts the whole run
+            m_cloudLabeler->beginSnapshotRun();
+            const bool completed = routeLocalFirst(cloudPaths);
+            goto_img(m_imgIndex);
+            if (!completed || cloudPaths.isEmpty())
+                m_cloudLabeler->endSnapshotRun();
+            if (!completed) return;
+            if (cloudPaths.isEmpty()) {
+                pjreddie_style_msgBox(QMessageBox::Information, "Auto Label All",
+                    QString("All %1 images were labeled locally.").arg(m_imgList.size()));
+                return;
+            }
+        }
+    }
+#endif
+
     m_btnCloudAutoLabel->setEnabled(false);
     m_btnCloudAutoLabelAll->setEnabled(false);
     m_btnCancelAutoLabel->setVisible(true);
     m_btnCloudAutoLabelAll->setText(
-        QString("\u2601 Auto Label All (0/%1)\u2026").arg(m_imgList.size()));
+        QString("\u2601 Auto Label All (0/%1)\u2026").arg(cloudPaths.size()));
 
     m_cloudLabeler->setApiKey(m_cloudApiKey);
     m_cloudLabeler->setPrompt(m_cloudPrompt);
     m_cloudLabeler->setClasses(m_objList);
-    m_cloudLabeler->labelImages(m_imgList);
+    m_cloudLabeler->labelImages(cloudPaths);
 }
 
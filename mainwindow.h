@@ -11,11 +11,14 @@
 #include <QSlider>
 #include <QLineEdit>
 #include <QTabWidget>
+#include <QCheckBox>
 
 #include "label_img.h"
 #include "cloud_labeler.h"
 #ifdef ONNXRUNTIME_AVAILABLE
 #include "yolo_detector.h"
+#include "hybrid_router.h"
+#include "label_work_queue.h"
 #endif
 #include <fstream>
 
@@ -104,6 +107,11 @@ private:
     void cancelAutoLabel();
     void submitCloudJob();
     void cloudAutoLabelAll();
+    void offerCloudResume();
+    void resumeCloudBatch();
+    void prioritizeCloudImages();
+    void saveBeforeLeavingImage();
+    void restoreLastCloudRun();
     bool checkUploadConsent();
 
     CloudAutoLabeler  *m_cloudLabeler;
@@ -113,6 +121,7 @@ private:
 
     QString    m_cloudApiKey;
     QString    m_cloudPrompt;
+    bool       m_cloudResumePending = false;  // accepted, waiting for an API key
 
     QTabWidget *m_sideTabWidget;
     QLineEdit  *m_settingsKeyEdit;
@@ -146,15 +155,29 @@ private:
     QSlider        *m_sliderConfidence;
     QLabel         *m_labelConfidence;
     QLabel         *m_labelModelStatus;
+    QString         m_modelStatusText;   // model info, without timings
+    QCheckBox      *m_checkSharedQueue;
 
     void on_loadModel_clicked();
     void loadOnnxModel(const QString& modelPath);
     void on_autoLabel_clicked();
     void on_autoLabelAll_clicked();
+    void autoLabelAllFromQueue();
+    void showDetectorTimings(bool batch);
     void on_confidenceSlider_changed(int value);
     void applyDetections(const std::vector<DetectionResult>& detections);
     void loadClassesFromModel();
     float getConfidenceThreshold() const;
+    QImage loadDetectorInput(const QString& imagePath);
+    bool writeDetectionLabels(const QString& imagePath,
+                              const std::vector<DetectionResult>& detections);
+
+    // Local-first routing for cloud "Auto Label All": the local model labels
+    // every image and only uncertain ones are left for the cloud.
+    QCheckBox        *m_checkLocalFirst;
+    RoutingThresholds m_routingThresholds;
+    bool canRouteLocalFirst() const;
+    bool routeLocalFirst(QStringList& cloudPaths);
 #endif
 
 protected:
@@ -0,0 +1,135 @@
+// Offline load benchmark for CloudAutoLabeler. Runs N synthetic images
+// through labelImages() against MockJobServer and reports throughput,
+// request counts and per-image latency percentiles, so scheduler changes
+// can be compared without touching the real API.
+//
+//   ./bench_cloud_labeler --images 5000 --min-latency 200 --max-latency 3000
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+
+#include "cloud_labeler.h"
+#include "mock_job_server.h"
+
+static qint64 percentile(QList<qint64> values, double p)
+{
+    if (values.isEmpty()) return 0;
+    std::sort(values.begin(), values.end());
+    const int idx = qBound(0, int(p * (values.size() - 1) + 0.5), int(values.size()) - 1);
+    return values[idx];
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load benchmark for the cloud auto-labeler");
+    parser.addHelpOption();
+    const QCommandLineOption imagesOpt("images", "Synthetic images to label (default 1000).", "n", "1000");
+    const QCommandLineOption bytesOpt("image-bytes", "Size of each synthetic image (default 50000).", "bytes", "50000");
+    const QCommandLineOption minLatOpt("min-latency", "Minimum job latency in ms (default 200).", "ms", "200");
+    const QCommandLineOption maxLatOpt("max-latency", "Maximum job latency in ms (default 2000).", "ms", "2000");
+    const QCommandLineOption failOpt("failure-rate", "Fraction of jobs that fail (default 0).", "rate", "0");
+    const QCommandLineOption errorOpt("error-rate", "Fraction of requests answered with 500 (default 0).", "rate", "0");
+    const QCommandLineOption limitOpt("rate-limit", "Fraction of polls answered with 429 (default 0).", "rate", "0");
+    const QCommandLineOption chunksOpt("chunks-in-flight", "Batch chunks kept active at once (default 2).", "n", "2");
+    parser.addOptions({ imagesOpt, bytesOpt, minLatOpt, maxLatOpt, failOpt, errorOpt, limitOpt, chunksOpt });
+    parser.process(app);
+
+    const int nImages = qMax(1, parser.value(imagesOpt).toInt());
+
+    MockJobServer server;
+    server.minLatencyMs   = parser.value(minLatOpt).toInt();
+    server.maxLatencyMs   = parser.value(maxLatOpt).toInt();
+    server.jobFailureRate = parser.value(failOpt).toDouble();
+    server.errorRate      = parser.value(errorOpt).toDouble();
+    server.rateLimitRate  = parser.value(limitOpt).toDouble();
+    if (!server.listen()) {
+        std::fprintf(stderr, "Could not start the mock server.\n");
+        return 1;
+    }
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "Could not create a temporary directory.\n");
+        return 1;
+    }
+    const QByteArray payload(qMax(1, parser.value(bytesOpt).toInt()), 'x');
+    QStringList paths;
+    paths.reserve(nImages);
+    for (int k = 0; k < nImages; ++k) {
+        const QString p = dir.filePath(QString("img%1.jpg").arg(k, 5, 10, QChar('0')));
+        QFile f(p);
+        if (!f.open(QIODevice::WriteOnly) || f.write(payload) != payload.size()) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(p));
+            return 1;
+        }
+        paths.append(p);
+    }
+
+    CloudAutoLabeler labeler;
+    labeler.setApiHost(server.url());
+    labeler.setApiKey("bench");
+    labeler.setClasses({ "object" });
+    labeler.setResultCacheDirectory(QString());
+    labeler.setJournalPath(QString());
+    labeler.setSnapshotDirectory(QString());
+    labeler.setMaxChunksInFlight(parser.value(chunksOpt).toInt());
+
+    QElapsedTimer clock;
+    QList<qint64> timeToLabel;   // ms from labelImages() to labelReady, per image
+    timeToLabel.reserve(nImages);
+    QString error;
+
+    QObject::connect(&labeler, &CloudAutoLabeler::labelReady, &app,
+                     [&](const QString &, int, int) { timeToLabel.append(clock.elapsed()); });
+    QObject::connect(&labeler, &CloudAutoLabeler::errorOccurred, &app,
+                     [&](const QString &message) { error = message; });
+    QObject::connect(&labeler, &CloudAutoLabeler::busyChanged, &app, [&](bool busy) {
+        if (!busy) app.quit();
+    });
+
+    clock.start();
+    labeler.labelImages(paths);
+    if (labeler.isBusy())
+        app.exec();
+    const qint64 wallMs = qMax<qint64>(1, clock.elapsed());
+
+    QTextStream out(stdout);
+    out << "images:            " << nImages << " x " << payload.size() << " bytes\n";
+    out << "labeled:           " << timeToLabel.size() << "\n";
+    out << "wall time:         " << wallMs << " ms\n";
+    out << "throughput:        " << QString::number(timeToLabel.size() * 1000.0 / wallMs, 'f', 1)
+        << " images/s\n";
+    out << "time to label:     p50 " << percentile(timeToLabel, 0.50)
+        << " ms, p99 " << percentile(timeToLabel, 0.99) << " ms\n";
+    out << "job turnaround:    p50 " << percentile(server.turnaroundMs, 0.50)
+        << " ms, p99 " << percentile(server.turnaroundMs, 0.99) << " ms\n";
+
+    out << "requests:\n";
+    QList<QByteArray> routes = server.requestCounts.keys();
+    std::sort(routes.begin(), routes.end());
+    int totalRequests = 0;
+    for (const QByteArray &route : std::as_const(routes)) {
+        const int n = server.requestCounts.value(route);
+        totalRequests += n;
+        out << "  " << QString::fromLatin1(route).leftJustified(28) << n << "\n";
+    }
+    out << "  " << QString("total").leftJustified(28) << totalRequests
+        << " (" << QString::number(double(totalRequests) / nImages, 'f', 2) << " per image)\n";
+    out << "  " << QString("answered 429").leftJustified(28) << server.rateLimitedReplies << "\n";
+    out << "  " << QString("answered 500").leftJustified(28) << server.errorReplies << "\n";
+
+    if (!error.isEmpty()) {
+        out << "error:             " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,6 @@
+QT += core gui network
+CONFIG += c++17 console
+CONFIG -= app_bundle
+SOURCES += bench_cloud_labeler.cpp mock_job_server.cpp ../cloud_labeler.cpp ../cloud_result_cache.cpp ../cloud_batch_journal.cpp ../label_snapshot_store.cpp
+HEADERS += mock_job_server.h ../cloud_labeler.h ../cloud_result_cache.h ../cloud_batch_journal.h ../label_snapshot_store.h
+INCLUDEPATH += ..
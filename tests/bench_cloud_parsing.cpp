@@ -0,0 +1,181 @@
+// Micro-benchmark for parsing cloud YOLO results. Compares the in-place
+// parser in CloudAutoLabeler with the previous QStringList/toDouble
+// implementation (kept below as a baseline) on a 5k-line reply.
+//
+//   ./bench_cloud_parsing                 # wall time
+//   ./bench_cloud_parsing -tickcounter    # CPU ticks, where supported
+#include <QtTest>
+#include <QRandomGenerator>
+#include "cloud_labeler.h"
+
+namespace legacy {
+
+QString filterValidDetections(const QString &yoloTxt, int numClasses)
+{
+    if (numClasses <= 0) return QString();
+
+    QString result;
+    for (const QString &rawLine : yoloTxt.split('\n')) {
+        const QString line = rawLine.trimmed();
+        if (line.isEmpty()) continue;
+
+        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() != 5) continue;
+
+        bool okId, okCx, okCy, okW, okH;
+        const int    classId = parts[0].toInt(&okId);
+        const double cx      = parts[1].toDouble(&okCx);
+        const double cy      = parts[2].toDouble(&okCy);
+        const double w       = parts[3].toDouble(&okW);
+        const double h       = parts[4].toDouble(&okH);
+
+        if (!okId || !okCx || !okCy || !okW || !okH) continue;
+        if (classId < 0 || classId >= numClasses)    continue;
+        if (cx < 0.0 || cx > 1.0 || cy < 0.0 || cy > 1.0) continue;
+        if (w <= 0.0 || w > 1.0  || h <= 0.0 || h > 1.0)  continue;
+
+        result += line + '\n';
+    }
+    return result;
+}
+
+QString remapWithClassNames(const QString &yoloTxt, const QStringList &serverClassNames,
+                            const QStringList &localClasses)
+{
+    if (localClasses.isEmpty()) return QString();
+
+    QHash<QString, int> nameToLocalId;
+    for (int j = 0; j < localClasses.size(); ++j)
+        nameToLocalId[localClasses[j].trimmed().toLower()] = j;
+
+    QHash<int, int> remap;
+    for (int serverId = 0; serverId < serverClassNames.size(); ++serverId)
+        remap[serverId] = nameToLocalId.value(serverClassNames[serverId].trimmed().toLower(), -1);
+
+    QString result;
+    for (const QString &rawLine : yoloTxt.split('\n')) {
+        const QString line = rawLine.trimmed();
+        if (line.isEmpty()) continue;
+
+        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() != 5) continue;
+
+        bool okId, okCx, okCy, okW, okH;
+        const int    serverId = parts[0].toInt(&okId);
+        const double cx       = parts[1].toDouble(&okCx);
+        const double cy       = parts[2].toDouble(&okCy);
+        const double w        = parts[3].toDouble(&okW);
+        const double h        = parts[4].toDouble(&okH);
+
+        if (!okId || !okCx || !okCy || !okW || !okH)        continue;
+        if (cx < 0.0 || cx > 1.0 || cy < 0.0 || cy > 1.0)  continue;
+        if (w <= 0.0 || w > 1.0  || h <= 0.0 || h > 1.0)   continue;
+
+        const int localId = remap.value(serverId, -1);
+        if (localId == -1) continue;
+
+        result += QString::number(localId) + line.mid(line.indexOf(' ')) + '\n';
+    }
+    return result;
+}
+
+} // namespace legacy
+
+class BenchCloudParsing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        // 5000 lines, about 2% of them malformed or out of range
+        QRandomGenerator rng(42);
+        for (int k = 0; k < LINES; ++k) {
+            const int r = int(rng.bounded(100));
+            if (r == 0) {
+                m_text += "7 0.5 0.5 0.2\n";
+            } else if (r == 1) {
+                m_text += "3 1.250000 0.500000 0.100000 0.100000\n";
+            } else {
+                m_text += QByteArray::number(rng.bounded(CLASSES)) + ' '
+                          + QByteArray::number(rng.generateDouble(), 'f', 6) + ' '
+                          + QByteArray::number(rng.generateDouble(), 'f', 6) + ' '
+                          + QByteArray::number(0.01 + rng.generateDouble() * 0.5, 'f', 6) + ' '
+                          + QByteArray::number(0.01 + rng.generateDouble() * 0.5, 'f', 6) + '\n';
+            }
+        }
+        for (int c = 0; c < CLASSES; ++c) {
+            m_serverNames.append(QString("Class%1").arg(c));
+            m_localNames.prepend(QString("class%1").arg(c));
+        }
+        m_reply = QJsonDocument(QJsonObject{ { "yolo_txt", QString::fromLatin1(m_text) } })
+                      .toJson(QJsonDocument::Compact);
+
+        // Both implementations must agree before their speed is compared
+        CloudAutoLabeler::JobResult result;
+        QVERIFY(CloudAutoLabeler::parseJobResult(m_reply, result));
+        QCOMPARE(result.yoloTxt, m_text);
+        QCOMPARE(CloudAutoLabeler::filterValidDetections(m_text, CLASSES),
+                 legacy::filterValidDetections(QString::fromLatin1(m_text), CLASSES).toUtf8());
+        QCOMPARE(CloudAutoLabeler::remapWithClassNames(m_text, m_serverNames, m_localNames),
+                 legacy::remapWithClassNames(QString::fromLatin1(m_text),
+                                             m_serverNames, m_localNames).toUtf8());
+    }
+
+    void filter_legacy()
+    {
+        QBENCHMARK {
+            const QString txt = QJsonDocument::fromJson(m_reply).object().value("yolo_txt").toString();
+            QByteArray out = legacy::filterValidDetections(txt, CLASSES).toUtf8();
+            Q_UNUSED(out);
+        }
+    }
+    void filter()
+    {
+        QBENCHMARK {
+            CloudAutoLabeler::JobResult result;
+            CloudAutoLabeler::parseJobResult(m_reply, result);
+            QByteArray out = CloudAutoLabeler::filterValidDetections(result.yoloTxt, CLASSES);
+            Q_UNUSED(out);
+        }
+    }
+    void remap_legacy()
+    {
+        QBENCHMARK {
+            const QString txt = QJsonDocument::fromJson(m_reply).object().value("yolo_txt").toString();
+            QByteArray out = legacy::remapWithClassNames(txt, m_serverNames, m_localNames).toUtf8();
+            Q_UNUSED(out);
+        }
+    }
+    void remap()
+    {
+        QBENCHMARK {
+            CloudAutoLabeler::JobResult result;
+            CloudAutoLabeler::parseJobResult(m_reply, result);
+            QByteArray out = CloudAutoLabeler::remapWithClassNames(result.yoloTxt, m_serverNames, m_localNames);
+            Q_UNUSED(out);
+        }
+    }
+    // Parsing alone, without reading the reply
+    void filterOnly_legacy()
+    {
+        const QString txt = QString::fromLatin1(m_text);
+        QBENCHMARK { legacy::filterValidDetections(txt, CLASSES); }
+    }
+    void filterOnly()
+    {
+        QBENCHMARK { CloudAutoLabeler::filterValidDetections(m_text, CLASSES); }
+    }
+
+private:
+    static constexpr int LINES   = 5000;
+    static constexpr int CLASSES = 80;
+
+    QByteArray  m_text;
+    QByteArray  m_reply;
+    QStringList m_serverNames;
+    QStringList m_localNames;
+};
+
+QTEST_GUILESS_MAIN(BenchCloudParsing)
+#include "bench_cloud_parsing.moc"
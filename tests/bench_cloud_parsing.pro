@@ -0,0 +1,6 @@
+QT += core gui network testlib
+CONFIG += c++17 console
+CONFIG -= app_bundle
+SOURCES += bench_cloud_parsing.cpp ../cloud_labeler.cpp ../cloud_result_cache.cpp ../cloud_batch_journal.cpp ../label_snapshot_store.cpp
+HEADERS += ../cloud_labeler.h ../cloud_result_cache.h ../cloud_batch_journal.h ../label_snapshot_store.h
+INCLUDEPATH += ..
@@ -0,0 +1,221 @@
+// Micro-benchmarks for the CPU stages of YoloDetector: letterbox
+// preprocessing, the three output decoders, NMS and IoU. Inputs are
+// synthetic tensors shaped like real model outputs, so no model file or
+// network access is needed.
+//
+//   ./bench_detector                      # all stages, wall time
+//   ./bench_detector postprocessV8        # one stage
+//   ./bench_detector -o base.xml,xml      # save results for comparison
+#include <QtTest>
+#include <QImage>
+#include <QRandomGenerator>
+#include "yolo_detector.h"
+
+class BenchDetector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ── preprocess ───────────────────────────────────────────────
+    void preprocess_data()
+    {
+        QTest::addColumn<int>("inputSize");
+        QTest::addColumn<QSize>("imageSize");
+        QTest::newRow("640 <- 640x480")    << 640  << QSize(640, 480);
+        QTest::newRow("640 <- 1920x1080")  << 640  << QSize(1920, 1080);
+        QTest::newRow("640 <- 4032x3024")  << 640  << QSize(4032, 3024);
+        QTest::newRow("1280 <- 1920x1080") << 1280 << QSize(1920, 1080);
+        QTest::newRow("1280 <- 4032x3024") << 1280 << QSize(4032, 3024);
+    }
+    void preprocess()
+    {
+        QFETCH(int, inputSize);
+        QFETCH(QSize, imageSize);
+
+        YoloDetector detector;
+        detector.m_inputWidth  = inputSize;
+        detector.m_inputHeight = inputSize;
+        const QImage image = noiseImage(imageSize);
+
+        float scaleX, scaleY, padX, padY;
+        QBENCHMARK {
+            std::vector<float> blob = detector.preprocess(image, scaleX, scaleY, padX, padY);
+            Q_UNUSED(blob);
+        }
+    }
+
+    // ── postprocess ──────────────────────────────────────────────
+    void postprocessV5_data() { decoderRows(); }
+    void postprocessV5()
+    {
+        QFETCH(int, classes);
+        QFETCH(int, candidates);
+
+        // [N, C+5]: cx, cy, w, h, objectness, class scores
+        const int stride = classes + 5;
+        std::vector<float> out(size_t(candidates) * stride);
+        QRandomGenerator rng(5);
+        for (int i = 0; i < candidates; ++i) {
+            float *row = out.data() + size_t(i) * stride;
+            randomBox(rng, row);
+            const bool hit = rng.bounded(10) == 0;
+            row[4] = hit ? 0.5f + 0.5f * float(rng.generateDouble()) : 0.2f * float(rng.generateDouble());
+            for (int c = 0; c < classes; ++c)
+                row[5 + c] = 0.3f * float(rng.generateDouble());
+            if (hit) row[5 + rng.bounded(classes)] = 0.9f;
+        }
+
+        YoloDetector detector;
+        QBENCHMARK {
+            auto dets = detector.postprocessV5(out.data(), candidates, classes, CONF,
+                                               1.0f, 1.0f, 0.0f, 0.0f, INPUT, INPUT);
+            Q_UNUSED(dets);
+        }
+    }
+    void postprocessV8_data() { decoderRows(); }
+    void postprocessV8()
+    {
+        QFETCH(int, classes);
+        QFETCH(int, candidates);
+
+        // [C+4, N]: one row per coordinate or class, one column per candidate
+        std::vector<float> out(size_t(classes + 4) * candidates);
+        QRandomGenerator rng(8);
+        for (int i = 0; i < candidates; ++i) {
+            float box[4];
+            randomBox(rng, box);
+            for (int k = 0; k < 4; ++k)
+                out[size_t(k) * candidates + i] = box[k];
+            for (int c = 0; c < classes; ++c)
+                out[size_t(4 + c) * candidates + i] = 0.2f * float(rng.generateDouble());
+            if (rng.bounded(10) == 0)
+                out[size_t(4 + rng.bounded(classes)) * candidates + i] = 0.5f + 0.5f * float(rng.generateDouble());
+        }
+
+        YoloDetector detector;
+        QBENCHMARK {
+            auto dets = detector.postprocessV8(out.data(), classes, candidates, CONF,
+                                               1.0f, 1.0f, 0.0f, 0.0f, INPUT, INPUT);
+            Q_UNUSED(dets);
+        }
+    }
+    void postprocessEndToEnd_data()
+    {
+        QTest::addColumn<int>("candidates");
+        for (int n : { 100, 300, 1000, 20000 })
+            QTest::addRow("%d dets", n) << n;
+    }
+    void postprocessEndToEnd()
+    {
+        QFETCH(int, candidates);
+
+        // [maxDet, 6]: x1, y1, x2, y2, score, class id
+        std::vector<float> out(size_t(candidates) * 6);
+        QRandomGenerator rng(26);
+        for (int i = 0; i < candidates; ++i) {
+            float *row = out.data() + size_t(i) * 6;
+            float box[4];
+            randomBox(rng, box);
+            row[0] = box[0] - box[2] / 2;
+            row[1] = box[1] - box[3] / 2;
+            row[2] = box[0] + box[2] / 2;
+            row[3] = box[1] + box[3] / 2;
+            row[4] = float(rng.generateDouble());
+            row[5] = float(rng.bounded(80));
+        }
+
+        YoloDetector detector;
+        QBENCHMARK {
+            auto dets = detector.postprocessEndToEnd(out.data(), candidates, CONF,
+                                                     1.0f, 1.0f, 0.0f, 0.0f, INPUT, INPUT);
+            Q_UNUSED(dets);
+        }
+    }
+
+    // ── nms / iou ────────────────────────────────────────────────
+    void nms_data()
+    {
+        QTest::addColumn<int>("candidates");
+        QTest::addColumn<int>("classes");
+        for (int n : { 100, 1000, 5000, 20000 })
+            QTest::addRow("%d boxes, 80 classes", n) << n << 80;
+        QTest::newRow("5000 boxes, 1 class") << 5000 << 1;
+    }
+    void nms()
+    {
+        QFETCH(int, candidates);
+        QFETCH(int, classes);
+        const std::vector<DetectionResult> boxes = randomDetections(candidates, classes, 42);
+        QBENCHMARK {
+            std::vector<int> keep = YoloDetector::nms(boxes, 0.45f);
+            Q_UNUSED(keep);
+        }
+    }
+    void iou()
+    {
+        const std::vector<DetectionResult> boxes = randomDetections(1000, 1, 7);
+        float sum = 0.0f;
+        QBENCHMARK {
+            for (size_t i = 0; i < boxes.size(); ++i)
+                for (size_t j = i + 1; j < boxes.size(); ++j)
+                    sum += YoloDetector::iou(boxes[i], boxes[j]);
+        }
+        QVERIFY(sum >= 0.0f);
+    }
+
+private:
+    static constexpr int   INPUT = 640;
+    static constexpr float CONF  = 0.25f;
+
+    static void decoderRows()
+    {
+        QTest::addColumn<int>("classes");
+        QTest::addColumn<int>("candidates");
+        // 8400 is the anchor count of a 640 input
+        for (int classes : { 80, 1000 })
+            for (int candidates : { 100, 8400, 20000 })
+                QTest::addRow("%d classes, %d candidates", classes, candidates)
+                    << classes << candidates;
+    }
+
+    static QImage noiseImage(const QSize &size)
+    {
+        QImage img(size, QImage::Format_RGB888);
+        QRandomGenerator rng(1);
+        for (int y = 0; y < img.height(); ++y) {
+            uchar *line = img.scanLine(y);
+            for (int x = 0; x < img.width() * 3; ++x)
+                line[x] = uchar(rng.bounded(256));
+        }
+        return img;
+    }
+
+    // cx, cy, w, h in letterbox pixels, clustered so that NMS has overlaps
+    static void randomBox(QRandomGenerator &rng, float *box)
+    {
+        const float clusterX = float(rng.bounded(8) * INPUT / 8 + INPUT / 16);
+        const float clusterY = float(rng.bounded(8) * INPUT / 8 + INPUT / 16);
+        box[0] = clusterX + float(rng.bounded(20)) - 10.0f;
+        box[1] = clusterY + float(rng.bounded(20)) - 10.0f;
+        box[2] = 30.0f + float(rng.bounded(40));
+        box[3] = 30.0f + float(rng.bounded(40));
+    }
+
+    static std::vector<DetectionResult> randomDetections(int n, int classes, quint32 seed)
+    {
+        QRandomGenerator rng(seed);
+        std::vector<DetectionResult> out;
+        out.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            float box[4];
+            randomBox(rng, box);
+            out.push_back({ int(rng.bounded(classes)), float(rng.generateDouble()),
+                            (box[0] - box[2] / 2) / INPUT, (box[1] - box[3] / 2) / INPUT,
+                            box[2] / INPUT, box[3] / INPUT });
+        }
+        return out;
+    }
+};
+
+QTEST_GUILESS_MAIN(BenchDetector)
+#include "bench_detector.moc"
@@ -0,0 +1,306 @@
+// End-to-end throughput benchmark for YoloDetector::detect() on generated
+// ONNX fixtures (see onnx_fixture.h), so it runs without model downloads or
+// network access. For each output format it reports:
+//
+//   - latency of one detector per intra-op thread count (p50/p90/p99, stage
+//     p50s from DetectorStats, operator new calls and bytes per detect());
+//   - throughput of N single-threaded detectors running side by side, as
+//     the batch labeler does, with the speedup over one detector.
+//
+//   ./bench_inference                                  # v5, v8, e2e; 80 classes
+//   ./bench_inference --kinds v8 --classes 1000 --threads 1,4,8
+//   ./bench_inference --output base.json
+//   ./bench_inference --save-models fixtures/          # just write the .onnx files
+//
+// Allocation counts cover global operator new, i.e. std containers in the
+// detector, and ONNX Runtime's own where the platform lets the executable
+// interpose them (Linux). Qt containers allocate with malloc and are not
+// counted.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "onnx_fixture.h"
+#include "yolo_detector.h"
+
+// ── allocation counting ──────────────────────────────────────────────
+
+static std::atomic<uint64_t> g_allocs{ 0 };
+static std::atomic<uint64_t> g_allocBytes{ 0 };
+
+static void *countedAlloc(std::size_t size)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+// ── helpers ──────────────────────────────────────────────────────────
+
+static double percentile(QList<double> values, double p)
+{
+    if (values.isEmpty()) return 0;
+    std::sort(values.begin(), values.end());
+    const int idx = qBound(0, int(p * (values.size() - 1) + 0.5), int(values.size()) - 1);
+    return values[idx];
+}
+
+static QList<int> parseInts(const QString &text)
+{
+    QList<int> values;
+    for (const QString &item : text.split(',', Qt::SkipEmptyParts))
+        if (item.trimmed().toInt() > 0)
+            values.append(item.trimmed().toInt());
+    return values;
+}
+
+// Smooth content, as the fixtures only look at the image through noise
+static QImage benchImage(const QSize &size)
+{
+    QImage img(size, QImage::Format_RGB888);
+    for (int y = 0; y < img.height(); ++y) {
+        uchar *line = img.scanLine(y);
+        for (int x = 0; x < img.width(); ++x) {
+            line[x * 3 + 0] = uchar(x);
+            line[x * 3 + 1] = uchar(y);
+            line[x * 3 + 2] = uchar(x + y);
+        }
+    }
+    return img;
+}
+
+static QString fmt(double v, int decimals = 2) { return QString::number(v, 'f', decimals); }
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int cores = int(qMax(1u, std::thread::hardware_concurrency()));
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Throughput benchmark for YoloDetector on generated ONNX fixtures");
+    parser.addHelpOption();
+    const QCommandLineOption kindsOpt("kinds", "Output formats: v5, v8, e2e (default all).", "list", "v5,v8,e2e");
+    const QCommandLineOption classesOpt("classes", "Classes per model (default 80).", "n", "80");
+    const QCommandLineOption imgszOpt("imgsz", "Model input size, a multiple of 32 (default 640).", "n", "640");
+    const QCommandLineOption imageOpt("image", "Input image size (default 1920x1080).", "WxH", "1920x1080");
+    const QCommandLineOption itersOpt("iterations", "Timed detect() calls per configuration (default 50).", "n", "50");
+    const QCommandLineOption warmupOpt("warmup", "Untimed calls first (default 3).", "n", "3");
+    const QCommandLineOption threadsOpt("threads",
+        QString("Thread counts to compare (default 1,2,4,%1).").arg(cores), "list",
+        QString("1,2,4,%1").arg(cores));
+    const QCommandLineOption outputOpt("output", "Write the results as JSON.", "file");
+    const QCommandLineOption saveOpt("save-models",
+        "Write the fixtures to a directory and exit, e.g. for yololabel-cli or test_inference.", "dir");
+    parser.addOptions({ kindsOpt, classesOpt, imgszOpt, imageOpt, itersOpt, warmupOpt,
+                        threadsOpt, outputOpt, saveOpt });
+    parser.process(app);
+
+    QList<OnnxFixtureKind> kinds;
+    for (const QString &k : parser.value(kindsOpt).split(',', Qt::SkipEmptyParts)) {
+        if (k == "v5")       kinds << OnnxFixtureKind::V5;
+        else if (k == "v8")  kinds << OnnxFixtureKind::V8;
+        else if (k == "e2e") kinds << OnnxFixtureKind::EndToEnd;
+        else {
+            std::fprintf(stderr, "Unknown kind '%s'.\n", qPrintable(k));
+            return 2;
+        }
+    }
+    QList<int> threadCounts = parseInts(parser.value(threadsOpt));
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    const QStringList wh = parser.value(imageOpt).split('x');
+    const QSize imageSize(wh.value(0).toInt(), wh.value(1).toInt());
+    const int iterations = qMax(1, parser.value(itersOpt).toInt());
+    const int warmup     = qMax(0, parser.value(warmupOpt).toInt());
+    if (kinds.isEmpty() || threadCounts.isEmpty() || imageSize.isEmpty()) {
+        std::fprintf(stderr, "Invalid --kinds, --threads or --image.\n\n%s", qPrintable(parser.helpText()));
+        return 2;
+    }
+
+    QTemporaryDir tmpDir;
+    QString modelDir = tmpDir.path();
+    if (parser.isSet(saveOpt)) {
+        modelDir = parser.value(saveOpt);
+        QDir().mkpath(modelDir);
+    }
+
+    QStringList modelPaths;
+    for (OnnxFixtureKind kind : std::as_const(kinds)) {
+        OnnxFixtureSpec spec;
+        spec.kind       = kind;
+        spec.numClasses = qMax(1, parser.value(classesOpt).toInt());
+        spec.inputSize  = parser.value(imgszOpt).toInt();
+        const QString path = QDir(modelDir).filePath(
+            QString("yolo_fixture_%1_c%2_%3.onnx").arg(onnxFixtureKindName(kind))
+                .arg(spec.numClasses).arg(spec.inputSize));
+        std::string error;
+        if (!writeOnnxFixture(path.toStdString(), spec, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        modelPaths << path;
+    }
+    QTextStream out(stdout);
+    if (parser.isSet(saveOpt)) {
+        for (const QString &p : std::as_const(modelPaths))
+            out << p << "\n";
+        return 0;
+    }
+
+    const QImage image = benchImage(imageSize);
+    QJsonArray json;
+
+    for (int k = 0; k < kinds.size(); ++k) {
+        const QString kindName = onnxFixtureKindName(kinds[k]);
+        const std::string modelPath = modelPaths[k].toStdString();
+        out << "\n" << kindName << " (" << parser.value(classesOpt) << " classes, "
+            << parser.value(imgszOpt) << " input, " << imageSize.width() << "x" << imageSize.height()
+            << " image)\n";
+
+        // One detector, intra-op threads varied
+        out << "  " << QString("intra-op").leftJustified(10)
+            << QString("p50 ms").rightJustified(9) << QString("p90 ms").rightJustified(9)
+            << QString("p99 ms").rightJustified(9) << QString("img/s").rightJustified(9)
+            << QString("allocs").rightJustified(9) << QString("KiB").rightJustified(9)
+            << "   pre / run / post / nms p50 ms\n";
+        for (int threads : std::as_const(threadCounts)) {
+            YoloDetector detector;
+            std::string error;
+            if (!detector.loadModel(modelPath, error, threads)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+            for (int i = 0; i < warmup; ++i)
+                detector.detect(image, 0.25f, 0.45f);
+            detector.resetStats();
+
+            QList<double> ms;
+            uint64_t allocs = 0, bytes = 0;
+            int kept = 0;
+            QElapsedTimer timer;
+            for (int i = 0; i < iterations; ++i) {
+                const uint64_t a0 = g_allocs.load(), b0 = g_allocBytes.load();
+                timer.start();
+                kept = int(detector.detect(image, 0.25f, 0.45f).size());
+                ms << timer.nsecsElapsed() / 1e6;
+                allocs += g_allocs.load() - a0;
+                bytes  += g_allocBytes.load() - b0;
+            }
+            double mean = 0;
+            for (double v : std::as_const(ms)) mean += v / ms.size();
+            const DetectorStageTimes p50 = detector.getStats().percentile(0.5);
+
+            out << "  " << QString::number(threads).leftJustified(10)
+                << fmt(percentile(ms, 0.50)).rightJustified(9) << fmt(percentile(ms, 0.90)).rightJustified(9)
+                << fmt(percentile(ms, 0.99)).rightJustified(9) << fmt(1000.0 / mean, 1).rightJustified(9)
+                << QString::number(allocs / iterations).rightJustified(9)
+                << QString::number(bytes / iterations / 1024).rightJustified(9)
+                << "   " << fmt(p50.preprocessMs) << " / " << fmt(p50.runMs) << " / "
+                << fmt(p50.postprocessMs) << " / " << fmt(p50.nmsMs) << "\n";
+
+            json.append(QJsonObject{
+                { "kind",            kindName },
+                { "mode",            "latency" },
+                { "threads",         threads },
+                { "p50_ms",          percentile(ms, 0.50) },
+                { "p90_ms",          percentile(ms, 0.90) },
+                { "p99_ms",          percentile(ms, 0.99) },
+                { "images_per_sec",  1000.0 / mean },
+                { "allocs_per_call", double(allocs) / iterations },
+                { "bytes_per_call",  double(bytes) / iterations },
+                { "preprocess_ms",   p50.preprocessMs },
+                { "run_ms",          p50.runMs },
+                { "postprocess_ms",  p50.postprocessMs },
+                { "nms_ms",          p50.nmsMs },
+                { "kept",            kept },
+            });
+        }
+
+        // N single-threaded detectors side by side; speedup is against the
+        // per-detector rate of the smallest count
+        out << "  " << QString("detectors").leftJustified(10)
+            << QString("img/s").rightJustified(9) << QString("speedup").rightJustified(9) << "\n";
+        double single = 0;
+        for (int n : std::as_const(threadCounts)) {
+            std::vector<std::unique_ptr<YoloDetector>> detectors;
+            for (int i = 0; i < n; ++i) {
+                detectors.push_back(std::make_unique<YoloDetector>());
+                std::string error;
+                if (!detectors.back()->loadModel(modelPath, error, 1)) {
+                    std::fprintf(stderr, "%s\n", error.c_str());
+                    return 1;
+                }
+                for (int w = 0; w < warmup; ++w)
+                    detectors.back()->detect(image, 0.25f, 0.45f);
+            }
+
+            QElapsedTimer wall;
+            wall.start();
+            std::vector<std::thread> workers;
+            for (int i = 0; i < n; ++i) {
+                workers.emplace_back([&, i]() {
+                    for (int it = 0; it < iterations; ++it)
+                        detectors[i]->detect(image, 0.25f, 0.45f);
+                });
+            }
+            for (std::thread &t : workers) t.join();
+            const double perSec = double(n) * iterations * 1e9 / qMax<qint64>(1, wall.nsecsElapsed());
+            if (single == 0) single = perSec / n;
+
+            out << "  " << QString::number(n).leftJustified(10)
+                << fmt(perSec, 1).rightJustified(9) << (fmt(perSec / single) + "x").rightJustified(9) << "\n";
+
+            json.append(QJsonObject{
+                { "kind",           kindName },
+                { "mode",           "parallel" },
+                { "threads",        n },
+                { "images_per_sec", perSec },
+                { "speedup",        perSec / single },
+            });
+        }
+    }
+
+    if (parser.isSet(outputOpt)) {
+        const QJsonObject root{
+            { "classes",    parser.value(classesOpt).toInt() },
+            { "imgsz",      parser.value(imgszOpt).toInt() },
+            { "image",      parser.value(imageOpt) },
+            { "iterations", iterations },
+            { "cores",      cores },
+            { "results",    json },
+        };
+        QSaveFile f(parser.value(outputOpt));
+        const QByteArray bytes = QJsonDocument(root).toJson(QJsonDocument::Indented);
+        if (!f.open(QIODevice::WriteOnly) || f.write(bytes) != bytes.size() || !f.commit()) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(f.fileName()));
+            return 1;
+        }
+        out << "\nresults written to " << f.fileName() << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,10 @@
+QT += core gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+DEFINES += ONNXRUNTIME_AVAILABLE
+SOURCES += bench_inference.cpp onnx_fixture.cpp ../yolo_detector.cpp
+HEADERS += onnx_fixture.h ../yolo_detector.h
+isEmpty(ONNXRUNTIME_DIR): ONNXRUNTIME_DIR = $$PWD/../onnxruntime
+INCLUDEPATH += .. $$ONNXRUNTIME_DIR/include
+LIBS += -L$$ONNXRUNTIME_DIR/lib -lonnxruntime
+unix: QMAKE_RPATHDIR += $$ONNXRUNTIME_DIR/lib
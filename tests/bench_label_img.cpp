@@ -0,0 +1,448 @@
+// Rendering and interaction benchmark for label_img. Drives the widget
+// offscreen through synthetic mouse-move, box-drag, wheel-zoom and pan
+// sequences on generated images and boxes, and reports per-event latency
+// percentiles for each sequence plus showImage(), findBoxUnderCursor(),
+// saveState() and loadLabelData(). Results can be saved as a JSON baseline
+// and later runs compared against it.
+//
+//   ./bench_label_img                                   # full matrix, up to 16384x16384
+//   ./bench_label_img --sizes 640x480,1920x1080 --boxes 0,1000
+//   ./bench_label_img --output base.json
+//   ./bench_label_img --baseline base.json --max-regression 1.5
+//
+// Each input event is sent through QCoreApplication::sendEvent() and then
+// presented with showImage(), which is what the coalesced repaint timer
+// would do; "event" is the handler alone, "frame" the handler plus the
+// repaint.
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "label_img.h"
+
+static const int NUM_CLASSES = 80;
+
+struct Samples
+{
+    QString       image;   // "WxH"
+    int           boxes = 0;
+    QString       op;
+    QList<qint64> ns;
+};
+
+static qint64 percentile(QList<qint64> values, double p)
+{
+    if (values.isEmpty()) return 0;
+    std::sort(values.begin(), values.end());
+    const int idx = qBound(0, int(p * (values.size() - 1) + 0.5), int(values.size()) - 1);
+    return values[idx];
+}
+
+static double toUs(qint64 ns) { return ns / 1000.0; }
+
+static QString resultKey(const QString &image, int boxes, const QString &op)
+{
+    return image + "|" + QString::number(boxes) + "|" + op;
+}
+
+static QList<QSize> parseSizes(const QString &text)
+{
+    QList<QSize> sizes;
+    for (const QString &item : text.split(',', Qt::SkipEmptyParts)) {
+        const QStringList wh = item.trimmed().split('x');
+        const int w = wh.value(0).toInt(), h = wh.value(1).toInt();
+        if (wh.size() == 2 && w > 0 && h > 0)
+            sizes.append(QSize(w, h));
+    }
+    return sizes;
+}
+
+static QList<int> parseInts(const QString &text)
+{
+    QList<int> values;
+    for (const QString &item : text.split(',', Qt::SkipEmptyParts))
+        values.append(qMax(0, item.trimmed().toInt()));
+    return values;
+}
+
+// Smooth gradients with fine texture, so scaling and JPEG decoding do
+// realistic work without the encode cost of pure noise.
+static QImage syntheticImage(const QSize &size)
+{
+    QImage img(size, QImage::Format_RGB888);
+    for (int y = 0; y < img.height(); ++y) {
+        uchar *line = img.scanLine(y);
+        const int gy = y * 255 / qMax(1, img.height() - 1);
+        for (int x = 0; x < img.width(); ++x) {
+            const int gx = x * 255 / qMax(1, img.width() - 1);
+            line[x * 3 + 0] = uchar(gx ^ (y & 0x1f));
+            line[x * 3 + 1] = uchar(gy ^ (x & 0x1f));
+            line[x * 3 + 2] = uchar((x * 7 + y * 13) & 0xff);
+        }
+    }
+    return img;
+}
+
+static QVector<ObjectLabelingBox> randomBoxes(int n, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QVector<ObjectLabelingBox> boxes;
+    boxes.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const double w = 0.01 + 0.09 * rng.generateDouble();
+        const double h = 0.01 + 0.09 * rng.generateDouble();
+        const double x = (1.0 - w) * rng.generateDouble();
+        const double y = (1.0 - h) * rng.generateDouble();
+        boxes.push_back({ int(rng.bounded(NUM_CLASSES)), QRectF(x, y, w, h) });
+    }
+    return boxes;
+}
+
+static bool writeLabels(const QString &path, const QVector<ObjectLabelingBox> &boxes)
+{
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    QByteArray text;
+    for (const ObjectLabelingBox &b : boxes) {
+        const QRectF &r = b.box;
+        text += QByteArray::number(b.label) + ' '
+              + QByteArray::number(r.center().x(), 'f', 6) + ' '
+              + QByteArray::number(r.center().y(), 'f', 6) + ' '
+              + QByteArray::number(r.width(), 'f', 6) + ' '
+              + QByteArray::number(r.height(), 'f', 6) + '\n';
+    }
+    return f.write(text) == text.size() && f.commit();
+}
+
+// Lissajous path over the widget, so hover crosses boxes and empty space
+static QPointF pathPoint(const QSize &widget, int i)
+{
+    return QPointF(widget.width()  * (0.5 + 0.45 * std::sin(i * 0.07)),
+                   widget.height() * (0.5 + 0.45 * std::sin(i * 0.11)));
+}
+
+class Runner
+{
+public:
+    Runner(label_img &widget, int events) : m_widget(widget), m_events(events) {}
+
+    QList<Samples> results;
+
+    void run(const QString &image, const QVector<ObjectLabelingBox> &boxes, const QString &labelPath)
+    {
+        m_image = image;
+        m_boxes = boxes;
+
+        reset();
+        sequence("move", [&](int i) {
+            return QMouseEvent(QEvent::MouseMove, pathPoint(m_widget.size(), i),
+                               m_widget.mapToGlobal(pathPoint(m_widget.size(), i)),
+                               Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        });
+
+        // Press on a box and drag it; without boxes the same gesture
+        // rubber-bands a new one.
+        reset();
+        const QPointF start = m_boxes.isEmpty()
+                ? QPointF(m_widget.width() * 0.25, m_widget.height() * 0.25)
+                : QPointF(m_widget.cvtRelativeToAbsolutePoint(m_boxes.first().box.center()));
+        send(QMouseEvent(QEvent::MouseButtonPress, start, m_widget.mapToGlobal(start),
+                         Qt::LeftButton, Qt::LeftButton, Qt::NoModifier));
+        sequence("drag", [&](int i) {
+            const QPointF p = start + QPointF((i % 200) * 2.0, (i % 150) * 1.5);
+            return QMouseEvent(QEvent::MouseMove, p, m_widget.mapToGlobal(p),
+                               Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+        });
+        send(QMouseEvent(QEvent::MouseButtonRelease, start, m_widget.mapToGlobal(start),
+                         Qt::LeftButton, Qt::NoButton, Qt::NoModifier));
+
+        // Ctrl+wheel in for the first half of the events, out for the rest
+        reset();
+        sequence("zoom", [&](int i) {
+            const QPointF p = pathPoint(m_widget.size(), i);
+            const int delta = i < m_events / 2 ? 120 : -120;
+            return QWheelEvent(p, m_widget.mapToGlobal(p), QPoint(), QPoint(0, delta),
+                               Qt::NoButton, Qt::ControlModifier, Qt::NoScrollPhase, false);
+        });
+
+        // Middle-button pan at about 4x zoom
+        reset();
+        const QPoint center(m_widget.width() / 2, m_widget.height() / 2);
+        for (int k = 0; k < 29; ++k)
+            m_widget.zoomIn(center);
+        send(QMouseEvent(QEvent::MouseButtonPress, QPointF(center), m_widget.mapToGlobal(QPointF(center)),
+                         Qt::MiddleButton, Qt::MiddleButton, Qt::NoModifier));
+        sequence("pan", [&](int i) {
+            const QPointF p = pathPoint(m_widget.size(), i);
+            return QMouseEvent(QEvent::MouseMove, p, m_widget.mapToGlobal(p),
+                               Qt::NoButton, Qt::MiddleButton, Qt::NoModifier);
+        });
+        send(QMouseEvent(QEvent::MouseButtonRelease, QPointF(center), m_widget.mapToGlobal(QPointF(center)),
+                         Qt::MiddleButton, Qt::NoButton, Qt::NoModifier));
+
+        reset();
+        QElapsedTimer timer;
+        {
+            Samples s = samples("findBoxUnderCursor");
+            QRandomGenerator rng(3);
+            int hits = 0;
+            for (int i = 0; i < m_events * 10; ++i) {
+                const QPointF p(rng.generateDouble(), rng.generateDouble());
+                timer.start();
+                hits += m_widget.findBoxUnderCursor(p) != -1;
+                s.ns.append(timer.nsecsElapsed());
+            }
+            Q_UNUSED(hits);
+            results.append(std::move(s));
+        }
+        {
+            // Past MAX_UNDO_HISTORY this includes dropping the oldest state
+            Samples s = samples("saveState");
+            for (int i = 0; i < m_events; ++i) {
+                timer.start();
+                m_widget.saveState();
+                s.ns.append(timer.nsecsElapsed());
+            }
+            results.append(std::move(s));
+        }
+        {
+            Samples s = samples("loadLabelData");
+            for (int i = 0; i < m_events; ++i) {
+                m_widget.m_objBoundingBoxes.clear();
+                timer.start();
+                m_widget.loadLabelData(labelPath);
+                s.ns.append(timer.nsecsElapsed());
+            }
+            results.append(std::move(s));
+        }
+    }
+
+private:
+    label_img                  &m_widget;
+    int                         m_events;
+    QString                     m_image;
+    QVector<ObjectLabelingBox>  m_boxes;
+
+    Samples samples(const QString &op) const
+    {
+        Samples s{ m_image, int(m_boxes.size()), op, {} };
+        s.ns.reserve(m_events);
+        return s;
+    }
+
+    void reset()
+    {
+        if (m_widget.m_bLabelingStarted) {
+            m_widget.releaseMouse();
+            m_widget.m_bLabelingStarted = false;
+        }
+        m_widget.resetZoom();
+        m_widget.m_objBoundingBoxes = m_boxes;
+        m_widget.clearUndoHistory();
+        m_widget.showImage();
+    }
+
+    template <class Event>
+    void send(Event ev)
+    {
+        QCoreApplication::sendEvent(&m_widget, &ev);
+    }
+
+    template <class MakeEvent>
+    void sequence(const QString &name, MakeEvent makeEvent)
+    {
+        Samples event = samples(name + ": event");
+        Samples show  = samples(name + ": showImage");
+        Samples frame = samples(name + ": frame");
+        QElapsedTimer timer;
+        for (int i = 0; i < m_events; ++i) {
+            auto ev = makeEvent(i);
+            timer.start();
+            QCoreApplication::sendEvent(&m_widget, &ev);
+            const qint64 handled = timer.nsecsElapsed();
+            m_widget.showImage();
+            const qint64 shown = timer.nsecsElapsed();
+            event.ns.append(handled);
+            show.ns.append(shown - handled);
+            frame.ns.append(shown);
+        }
+        results << event << show << frame;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Rendering and interaction benchmark for the labeling widget");
+    parser.addHelpOption();
+    const QCommandLineOption sizesOpt("sizes",
+        "Comma-separated image sizes (default 640x480,1920x1080,4032x3024,8192x8192,16384x16384).",
+        "WxH,...", "640x480,1920x1080,4032x3024,8192x8192,16384x16384");
+    const QCommandLineOption boxesOpt("boxes", "Comma-separated box counts (default 0,100,1000,10000).",
+        "n,...", "0,100,1000,10000");
+    const QCommandLineOption eventsOpt("events", "Events per sequence (default 100).", "n", "100");
+    const QCommandLineOption widgetOpt("widget", "Widget size (default 1280x720).", "WxH", "1280x720");
+    const QCommandLineOption outputOpt("output", "Write the results to a JSON baseline.", "file");
+    const QCommandLineOption baselineOpt("baseline", "Compare p50 and p99 against a saved baseline.", "file");
+    const QCommandLineOption regressOpt("max-regression",
+        "Exit with 1 if any p50 exceeds the baseline by this factor (default 0: report only).",
+        "factor", "0");
+    parser.addOptions({ sizesOpt, boxesOpt, eventsOpt, widgetOpt, outputOpt, baselineOpt, regressOpt });
+    parser.process(app);
+
+    const QList<QSize> sizes = parseSizes(parser.value(sizesOpt));
+    const QList<int>   boxCounts = parseInts(parser.value(boxesOpt));
+    const QList<QSize> widgetSizes = parseSizes(parser.value(widgetOpt));
+    const int          events = qMax(2, parser.value(eventsOpt).toInt());
+    if (sizes.isEmpty() || boxCounts.isEmpty() || widgetSizes.isEmpty()) {
+        std::fprintf(stderr, "Invalid --sizes, --boxes or --widget.\n\n%s", qPrintable(parser.helpText()));
+        return 2;
+    }
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "Could not create a temporary directory.\n");
+        return 1;
+    }
+
+    label_img widget;
+    widget.resize(widgetSizes.first());
+    widget.m_bVisualizeClassName = true;
+    for (int c = 0; c < NUM_CLASSES; ++c) {
+        widget.m_objList.append(QString("class_%1").arg(c));
+        widget.m_drawObjectBoxColor.append(label_img::BOX_COLORS[c % 10]);
+    }
+    widget.show();
+
+    QTextStream out(stdout);
+    Runner runner(widget, events);
+    for (const QSize &size : sizes) {
+        const QString image = QString("%1x%2").arg(size.width()).arg(size.height());
+        const QString imagePath = dir.filePath(image + ".jpg");
+        if (!syntheticImage(size).save(imagePath, "JPG", 90)) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(imagePath));
+            return 1;
+        }
+        bool ret = false;
+        widget.openImage(imagePath, ret);
+        if (!ret) {
+            std::fprintf(stderr, "Could not open %s\n", qPrintable(imagePath));
+            return 1;
+        }
+
+        for (int n : boxCounts) {
+            out << "running " << image << ", " << n << " boxes\n";
+            out.flush();
+            const QVector<ObjectLabelingBox> boxes = randomBoxes(n, quint32(n) + 1);
+            const QString labelPath = dir.filePath(QString("%1-%2.txt").arg(image).arg(n));
+            if (!writeLabels(labelPath, boxes)) {
+                std::fprintf(stderr, "Could not write %s\n", qPrintable(labelPath));
+                return 1;
+            }
+            runner.run(image, boxes, labelPath);
+        }
+        QFile::remove(imagePath);
+    }
+
+    QMap<QString, QJsonObject> baseline;
+    if (parser.isSet(baselineOpt)) {
+        QFile f(parser.value(baselineOpt));
+        if (!f.open(QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "Could not read %s\n", qPrintable(f.fileName()));
+            return 1;
+        }
+        const QJsonArray entries = QJsonDocument::fromJson(f.readAll()).object().value("results").toArray();
+        for (const QJsonValue &v : entries) {
+            const QJsonObject o = v.toObject();
+            baseline.insert(resultKey(o.value("image").toString(), o.value("boxes").toInt(),
+                                      o.value("op").toString()), o);
+        }
+    }
+    const double maxRegression = parser.value(regressOpt).toDouble();
+
+    out << "\n" << QString("image").leftJustified(13) << QString("boxes").rightJustified(6) << "  "
+        << QString("op").leftJustified(22)
+        << QString("p50 us").rightJustified(11) << QString("p90 us").rightJustified(11)
+        << QString("p99 us").rightJustified(11) << QString("max us").rightJustified(11);
+    if (!baseline.isEmpty())
+        out << QString("p50 vs base").rightJustified(13) << QString("p99 vs base").rightJustified(13);
+    out << "\n";
+
+    QJsonArray json;
+    int regressions = 0;
+    for (const Samples &s : std::as_const(runner.results)) {
+        const qint64 p50 = percentile(s.ns, 0.50), p90 = percentile(s.ns, 0.90);
+        const qint64 p99 = percentile(s.ns, 0.99), worst = percentile(s.ns, 1.0);
+        out << s.image.leftJustified(13) << QString::number(s.boxes).rightJustified(6) << "  "
+            << s.op.leftJustified(22)
+            << QString::number(toUs(p50), 'f', 1).rightJustified(11)
+            << QString::number(toUs(p90), 'f', 1).rightJustified(11)
+            << QString::number(toUs(p99), 'f', 1).rightJustified(11)
+            << QString::number(toUs(worst), 'f', 1).rightJustified(11);
+
+        const auto base = baseline.constFind(resultKey(s.image, s.boxes, s.op));
+        if (base != baseline.constEnd()) {
+            const double baseP50 = base->value("p50_us").toDouble();
+            const double baseP99 = base->value("p99_us").toDouble();
+            const double r50 = baseP50 > 0 ? toUs(p50) / baseP50 : 1.0;
+            const double r99 = baseP99 > 0 ? toUs(p99) / baseP99 : 1.0;
+            // Sub-microsecond timings are mostly timer noise
+            const bool regressed = maxRegression > 0 && baseP50 >= 1.0 && r50 > maxRegression;
+            regressions += regressed;
+            out << (QString::number(r50, 'f', 2) + "x").rightJustified(13)
+                << (QString::number(r99, 'f', 2) + "x").rightJustified(13)
+                << (regressed ? "  REGRESSED" : "");
+        }
+        out << "\n";
+
+        json.append(QJsonObject{
+            { "image",   s.image },
+            { "boxes",   s.boxes },
+            { "op",      s.op },
+            { "count",   int(s.ns.size()) },
+            { "p50_us",  toUs(p50) },
+            { "p90_us",  toUs(p90) },
+            { "p99_us",  toUs(p99) },
+            { "max_us",  toUs(worst) },
+        });
+    }
+
+    if (parser.isSet(outputOpt)) {
+        const QJsonObject root{
+            { "widget",  QString("%1x%2").arg(widget.width()).arg(widget.height()) },
+            { "events",  events },
+            { "results", json },
+        };
+        QSaveFile f(parser.value(outputOpt));
+        const QByteArray bytes = QJsonDocument(root).toJson(QJsonDocument::Indented);
+        if (!f.open(QIODevice::WriteOnly) || f.write(bytes) != bytes.size() || !f.commit()) {
+            std::fprintf(stderr, "Could not write %s\n", qPrintable(f.fileName()));
+            return 1;
+        }
+        out << "baseline written to " << f.fileName() << "\n";
+    }
+
+    if (regressions > 0) {
+        out << regressions << " result(s) regressed by more than " << maxRegression << "x\n";
+        return 1;
+    }
+    return 0;
+}
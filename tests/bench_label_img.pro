@@ -0,0 +1,6 @@
+QT += core gui widgets
+CONFIG += c++17 console
+CONFIG -= app_bundle
+SOURCES += bench_label_img.cpp ../label_img.cpp ../image_cache.cpp
+HEADERS += ../label_img.h ../image_cache.h
+INCLUDEPATH += ..
@@ -0,0 +1,152 @@
+#include "mock_job_server.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTcpSocket>
+
+MockJobServer::MockJobServer(quint32 seed)
+    : m_rng(seed)
+{
+}
+
+bool MockJobServer::listen()
+{
+    QObject::connect(&m_server, &QTcpServer::newConnection, &m_server, [this]() {
+        while (QTcpSocket *sock = m_server.nextPendingConnection()) {
+            QObject::connect(sock, &QTcpSocket::readyRead, sock, [this, sock]() { onReadyRead(sock); });
+            QObject::connect(sock, &QTcpSocket::disconnected, sock, [this, sock]() {
+                m_buffers.remove(sock);
+                sock->deleteLater();
+            });
+        }
+    });
+    m_clock.start();
+    return m_server.listen(QHostAddress::LocalHost, 0);
+}
+
+QString MockJobServer::url() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_server.serverPort());
+}
+
+void MockJobServer::onReadyRead(QTcpSocket *sock)
+{
+    QByteArray &buf = m_buffers[sock];
+    buf += sock->readAll();
+    for (;;) {
+        const int headerEnd = buf.indexOf("\r\n\r\n");
+        if (headerEnd < 0) return;
+        const QList<QByteArray> lines = buf.left(headerEnd).split('\n');
+        qint64 contentLength = 0;
+        for (const QByteArray &line : lines) {
+            if (line.toLower().startsWith("content-length:"))
+                contentLength = line.mid(15).trimmed().toLongLong();
+        }
+        if (buf.size() < headerEnd + 4 + contentLength) return;
+
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        const QByteArray body = buf.mid(headerEnd + 4, contentLength);
+        buf.remove(0, headerEnd + 4 + contentLength);
+        handle(sock, requestLine.value(0), requestLine.value(1), body);
+    }
+}
+
+void MockJobServer::handle(QTcpSocket *sock, const QByteArray &method, const QByteArray &path,
+                           const QByteArray &body)
+{
+    const qint64 now = m_clock.elapsed();
+    const QList<QByteArray> parts = path.split('/');  // "", "v1", "jobs", ...
+
+    QByteArray route = method + ' ' + path;
+    if (parts.size() >= 4 && parts[3] != "batch")
+        route = method + " /v1/jobs/{id}" + (parts.size() == 5 ? "/" + parts[4] : QByteArray());
+    ++requestCounts[route];
+
+    if (chance(errorRate)) {
+        ++errorReplies;
+        reply(sock, 500, QJsonObject{{ "error", "internal error" }});
+        return;
+    }
+
+    if (method == "POST" && path == "/v1/jobs") {
+        reply(sock, 200, QJsonObject{{ "job_id", createJob(now) }});
+    } else if (method == "POST" && path == "/v1/jobs/batch") {
+        ++batchSubmits;
+        if (submitStatus != 0) {
+            reply(sock, submitStatus, QJsonObject{{ "error", "rejected" }});
+            return;
+        }
+        if (rateLimitedSubmits > 0) {
+            --rateLimitedSubmits;
+            ++rateLimitedReplies;
+            reply(sock, 429, QJsonObject{{ "error", "rate limited" }},
+                  "Retry-After: " + QByteArray::number(retryAfterSec) + "\r\n");
+            return;
+        }
+        const int n = body.count("name=\"images\"");
+        if (maxBatchImages > 0 && n > maxBatchImages) {
+            reply(sock, 413, QJsonObject{{ "error", "payload too large" }});
+            return;
+        }
+        acceptedBatchSizes.append(n);
+        QJsonArray ids;
+        for (int k = 0; k < n; ++k)
+            ids.append(createJob(now));
+        reply(sock, 200, QJsonObject{{ "job_ids", ids }});
+    } else if (method == "GET" && parts.size() == 5 && parts[4] == "result") {
+        const qint64 id = parts[3].toLongLong();
+        if (m_createdAt.contains(id))
+            turnaroundMs.append(now - m_createdAt.take(id));
+        reply(sock, 200, QJsonObject{{ "yolo_txt", "0 0.5 0.5 0.2 0.2\n" }});
+    } else if (method == "GET" && parts.size() == 4) {
+        const qint64 id = parts[3].toLongLong();
+        ++pollsPerJob[id];
+        pollTimes.append(now);
+        if (rateLimitedPolls > 0 || chance(rateLimitRate)) {
+            if (rateLimitedPolls > 0) --rateLimitedPolls;
+            ++rateLimitedReplies;
+            reply(sock, 429, QJsonObject{{ "error", "rate limited" }},
+                  "Retry-After: " + QByteArray::number(retryAfterSec) + "\r\n");
+            return;
+        }
+        QString status = "running";
+        if (now >= m_readyAt.value(id, 0))
+            status = m_fails.value(id, false) ? "failed" : "succeeded";
+        reply(sock, 200, QJsonObject{{ "status", status }});
+    } else {
+        reply(sock, 404, QJsonObject{{ "error", "not found" }});
+    }
+}
+
+qint64 MockJobServer::createJob(qint64 now)
+{
+    const qint64 id = m_nextJobId++;
+    int latency = latenciesMs.value(int(id - 1), -1);
+    if (latency < 0) {
+        latency = maxLatencyMs > minLatencyMs
+                  ? minLatencyMs + int(m_rng.bounded(maxLatencyMs - minLatencyMs + 1))
+                  : minLatencyMs;
+    }
+    m_createdAt[id] = now;
+    m_readyAt[id]   = now + latency;
+    if (chance(jobFailureRate))
+        m_fails[id] = true;
+    return id;
+}
+
+bool MockJobServer::chance(double rate)
+{
+    return rate > 0.0 && m_rng.generateDouble() < rate;
+}
+
+void MockJobServer::reply(QTcpSocket *sock, int status, const QJsonObject &obj,
+                          const QByteArray &extraHeaders)
+{
+    const QByteArray body = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    QByteArray out = "HTTP/1.1 " + QByteArray::number(status)
+                     + (status == 200 ? " OK" : " Error") + "\r\n";
+    out += "Content-Type: application/json\r\n";
+    out += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    out += extraHeaders + "\r\n" + body;
+    sock->write(out);
+}
@@ -0,0 +1,73 @@
+#ifndef MOCK_JOB_SERVER_H
+#define MOCK_JOB_SERVER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QRandomGenerator>
+#include <QString>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+// Minimal HTTP/1.1 stand-in for the cloud API, shared by the unit tests and
+// the load benchmark. Serves POST /v1/jobs, POST /v1/jobs/batch,
+// GET /v1/jobs/{id} and GET /v1/jobs/{id}/result. Each job reports
+// "running" until its latency has elapsed, then "succeeded" (or "failed").
+// Unknown job IDs report "succeeded". Random draws use a fixed seed so runs
+// are repeatable.
+class MockJobServer
+{
+public:
+    explicit MockJobServer(quint32 seed = 1);
+
+    // Job latency: latenciesMs[id - 1] when set, otherwise uniform in
+    // [minLatencyMs, maxLatencyMs].
+    QList<int> latenciesMs;              // per job, in submission order
+    int        minLatencyMs     = 0;
+    int        maxLatencyMs     = 0;
+
+    double     jobFailureRate   = 0.0;   // fraction of jobs that end "failed"
+    double     errorRate        = 0.0;   // fraction of requests answered with 500
+    double     rateLimitRate    = 0.0;   // fraction of status polls answered with 429
+    int        rateLimitedPolls = 0;     // answer this many status polls with 429
+    int        retryAfterSec    = 1;
+    int        maxBatchImages   = 0;     // reject larger batch submits with 413
+    int        rateLimitedSubmits = 0;   // answer this many batch submits with 429
+    int        submitStatus     = 0;     // answer every batch submit with this status
+
+    int                    batchSubmits = 0;
+    QList<int>             acceptedBatchSizes;
+    QHash<qint64, int>     pollsPerJob;
+    QList<qint64>          pollTimes;      // ms since listen(), one per status poll
+    QHash<QByteArray, int> requestCounts;  // "GET /v1/jobs/{id}" etc.
+    QList<qint64>          turnaroundMs;   // job creation to first result GET, per job
+    int                    rateLimitedReplies = 0;
+    int                    errorReplies       = 0;
+
+    bool listen();
+    QString url() const;
+
+private:
+    void onReadyRead(QTcpSocket *sock);
+    void handle(QTcpSocket *sock, const QByteArray &method, const QByteArray &path,
+                const QByteArray &body);
+    qint64 createJob(qint64 now);
+    bool chance(double rate);
+
+    static void reply(QTcpSocket *sock, int status, const QJsonObject &obj,
+                      const QByteArray &extraHeaders = QByteArray());
+
+    QTcpServer                      m_server;
+    QElapsedTimer                   m_clock;
+    QRandomGenerator                m_rng;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QHash<qint64, qint64>           m_createdAt;
+    QHash<qint64, qint64>           m_readyAt;
+    QHash<qint64, bool>             m_fails;
+    qint64                          m_nextJobId = 1;
+};
+
+#endif // MOCK_JOB_SERVER_H
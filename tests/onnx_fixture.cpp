@@ -0,0 +1,441 @@
+#include "onnx_fixture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// ── protobuf wire format ─────────────────────────────────────────────
+// Just enough of it to write onnx.proto messages: varints, length-
+// delimited fields and fixed32 floats. Field numbers are from onnx.proto.
+
+class Proto
+{
+public:
+    void varint(int field, uint64_t v) { tag(field, 0); raw(v); }
+    void bytes(int field, const std::string& s) { tag(field, 2); raw(s.size()); m_buf += s; }
+    void message(int field, const Proto& m) { bytes(field, m.m_buf); }
+    void floatValue(int field, float f)
+    {
+        tag(field, 5);
+        char b[4];
+        std::memcpy(b, &f, 4);
+        m_buf.append(b, 4);
+    }
+    const std::string& data() const { return m_buf; }
+
+private:
+    std::string m_buf;
+
+    void tag(int field, int wireType) { raw((uint64_t(field) << 3) | uint64_t(wireType)); }
+    void raw(uint64_t v)
+    {
+        while (v >= 0x80) {
+            m_buf += char((v & 0x7f) | 0x80);
+            v >>= 7;
+        }
+        m_buf += char(v);
+    }
+};
+
+enum TensorType { FLOAT = 1, INT64 = 7 };
+enum AttributeType { ATTR_INT = 2, ATTR_INTS = 7 };
+
+// Raw data is stored in host byte order, i.e. little-endian on every
+// platform CI builds for.
+Proto floatTensor(const std::string& name, const std::vector<int64_t>& dims, const std::vector<float>& values)
+{
+    Proto t;
+    for (int64_t d : dims) t.varint(1, uint64_t(d));
+    t.varint(2, FLOAT);
+    t.bytes(8, name);
+    t.bytes(9, std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float)));
+    return t;
+}
+
+Proto int64Tensor(const std::string& name, const std::vector<int64_t>& values)
+{
+    Proto t;
+    t.varint(1, values.size());
+    t.varint(2, INT64);
+    t.bytes(8, name);
+    t.bytes(9, std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int64_t)));
+    return t;
+}
+
+Proto valueInfo(const std::string& name, const std::vector<int64_t>& dims)
+{
+    Proto shape;
+    for (int64_t d : dims) {
+        Proto dim;
+        dim.varint(1, uint64_t(d));
+        shape.message(1, dim);
+    }
+    Proto tensorType;
+    tensorType.varint(1, FLOAT);
+    tensorType.message(2, shape);
+    Proto type;
+    type.message(1, tensorType);
+
+    Proto info;
+    info.bytes(1, name);
+    info.message(2, type);
+    return info;
+}
+
+Proto intsAttribute(const std::string& name, const std::vector<int64_t>& values)
+{
+    Proto a;
+    a.bytes(1, name);
+    for (int64_t v : values) a.varint(8, uint64_t(v));
+    a.varint(20, ATTR_INTS);
+    return a;
+}
+
+Proto intAttribute(const std::string& name, int64_t value)
+{
+    Proto a;
+    a.bytes(1, name);
+    a.varint(3, uint64_t(value));
+    a.varint(20, ATTR_INT);
+    return a;
+}
+
+class Graph
+{
+public:
+    void node(const std::string& op, const std::vector<std::string>& inputs,
+              const std::string& output, const std::vector<Proto>& attributes = {})
+    {
+        Proto n;
+        for (const auto& in : inputs) n.bytes(1, in);
+        n.bytes(2, output);
+        n.bytes(3, output);
+        n.bytes(4, op);
+        for (const auto& a : attributes) n.message(5, a);
+        m_graph.message(1, n);
+    }
+    void initializer(const Proto& tensor) { m_graph.message(5, tensor); }
+    void input(const Proto& info) { m_graph.message(11, info); }
+    void output(const Proto& info) { m_graph.message(12, info); }
+
+    Proto build(const std::string& name)
+    {
+        Proto g = m_graph;
+        g.bytes(2, name);
+        return g;
+    }
+
+private:
+    Proto m_graph;
+};
+
+// ── synthetic head values ────────────────────────────────────────────
+
+// xorshift32, so fixtures are identical across standard libraries
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : m_state(seed ? seed : 0x9e3779b9u) {}
+    float uniform()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return float(m_state >> 8) / float(1u << 24);
+    }
+    float uniform(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+    int bounded(int n) { return std::min(n - 1, int(uniform() * float(n))); }
+
+private:
+    uint32_t m_state;
+};
+
+const int STRIDES[] = { 8, 16, 32 };
+
+struct PlantedObject {
+    int   classId;
+    float cx, cy, w, h;
+    float peak;
+};
+
+struct Anchor {
+    float x, y;
+    int   stride;
+};
+
+std::vector<PlantedObject> plantObjects(const OnnxFixtureSpec& spec, Rng& rng)
+{
+    const float size = float(spec.inputSize);
+    std::vector<PlantedObject> objects;
+    for (int i = 0; i < spec.objects; ++i) {
+        PlantedObject o;
+        o.classId = rng.bounded(spec.numClasses);
+        o.w  = rng.uniform(20.0f, 0.3f * size);
+        o.h  = rng.uniform(20.0f, 0.3f * size);
+        o.cx = rng.uniform(o.w / 2, size - o.w / 2);
+        o.cy = rng.uniform(o.h / 2, size - o.h / 2);
+        o.peak = rng.uniform(0.6f, 0.95f);
+        objects.push_back(o);
+    }
+    // Highest score first, as end-to-end models emit them
+    std::sort(objects.begin(), objects.end(),
+              [](const PlantedObject& a, const PlantedObject& b) { return a.peak > b.peak; });
+    return objects;
+}
+
+// Anchor cells in head order: stride, then (V5 only) anchor, then row-major
+std::vector<Anchor> anchors(const OnnxFixtureSpec& spec, int perCell)
+{
+    std::vector<Anchor> out;
+    for (int s : STRIDES) {
+        const int g = spec.inputSize / s;
+        for (int k = 0; k < perCell; ++k)
+            for (int gy = 0; gy < g; ++gy)
+                for (int gx = 0; gx < g; ++gx)
+                    out.push_back({ (gx + 0.5f) * s, (gy + 0.5f) * s, s });
+    }
+    return out;
+}
+
+// Score of the best planted object covering an anchor, peaking at the
+// object's center so that each object yields a cluster of overlapping
+// candidates for NMS.
+float anchorScore(const Anchor& a, const std::vector<PlantedObject>& objects, int& objectIdx)
+{
+    float best = 0.0f;
+    objectIdx = -1;
+    for (size_t j = 0; j < objects.size(); ++j) {
+        const PlantedObject& o = objects[j];
+        const float d = std::max(std::fabs(a.x - o.cx) / (o.w / 2), std::fabs(a.y - o.cy) / (o.h / 2));
+        if (d >= 1.0f) continue;
+        const float score = o.peak * (1.0f - d) * (1.0f - d);
+        if (score > best) {
+            best = score;
+            objectIdx = int(j);
+        }
+    }
+    return best;
+}
+
+// [1, C + 4, A]
+std::vector<float> v8Bias(const OnnxFixtureSpec& spec, Rng& rng, const std::vector<PlantedObject>& objects)
+{
+    const std::vector<Anchor> cells = anchors(spec, 1);
+    const size_t n = cells.size();
+    std::vector<float> out(size_t(spec.numClasses + 4) * n);
+    for (size_t i = 0; i < n; ++i) {
+        int j;
+        const float score = anchorScore(cells[i], objects, j);
+        const float jitter = rng.uniform(-2.0f, 2.0f);
+        out[0 * n + i] = j >= 0 ? objects[j].cx + jitter : cells[i].x;
+        out[1 * n + i] = j >= 0 ? objects[j].cy - jitter : cells[i].y;
+        out[2 * n + i] = j >= 0 ? objects[j].w + jitter : 2.0f * cells[i].stride;
+        out[3 * n + i] = j >= 0 ? objects[j].h - jitter : 2.0f * cells[i].stride;
+        for (int c = 0; c < spec.numClasses; ++c)
+            out[size_t(4 + c) * n + i] = rng.uniform(0.0f, 0.02f);
+        if (j >= 0)
+            out[size_t(4 + objects[j].classId) * n + i] = score;
+    }
+    return out;
+}
+
+// [1, A, C + 5]
+std::vector<float> v5Bias(const OnnxFixtureSpec& spec, Rng& rng, const std::vector<PlantedObject>& objects)
+{
+    const std::vector<Anchor> cells = anchors(spec, 3);
+    const int stride = spec.numClasses + 5;
+    std::vector<float> out(cells.size() * size_t(stride));
+    for (size_t i = 0; i < cells.size(); ++i) {
+        float* row = out.data() + i * size_t(stride);
+        int j;
+        const float score = anchorScore(cells[i], objects, j);
+        const float jitter = rng.uniform(-2.0f, 2.0f);
+        row[0] = j >= 0 ? objects[j].cx + jitter : cells[i].x;
+        row[1] = j >= 0 ? objects[j].cy - jitter : cells[i].y;
+        row[2] = j >= 0 ? objects[j].w + jitter : 2.0f * cells[i].stride;
+        row[3] = j >= 0 ? objects[j].h - jitter : 2.0f * cells[i].stride;
+        row[4] = j >= 0 ? score : rng.uniform(0.0f, 0.01f);
+        for (int c = 0; c < spec.numClasses; ++c)
+            row[5 + c] = rng.uniform(0.0f, 0.02f);
+        if (j >= 0)
+            row[5 + objects[j].classId] = rng.uniform(0.85f, 0.99f);
+    }
+    return out;
+}
+
+// [1, maxDet, 6]. Class ids sit at k + 0.5 so that the conv noise never
+// moves their integer part.
+std::vector<float> endToEndBias(const OnnxFixtureSpec& spec, Rng& rng, const std::vector<PlantedObject>& objects)
+{
+    std::vector<float> out(size_t(spec.maxDetections) * 6);
+    const float size = float(spec.inputSize);
+    for (int i = 0; i < spec.maxDetections; ++i) {
+        float* row = out.data() + size_t(i) * 6;
+        if (i < int(objects.size())) {
+            const PlantedObject& o = objects[i];
+            row[0] = o.cx - o.w / 2;
+            row[1] = o.cy - o.h / 2;
+            row[2] = o.cx + o.w / 2;
+            row[3] = o.cy + o.h / 2;
+            row[4] = o.peak;
+            row[5] = float(o.classId) + 0.5f;
+        } else {
+            const float x = rng.uniform(0.0f, size - 40.0f), y = rng.uniform(0.0f, size - 40.0f);
+            row[0] = x;
+            row[1] = y;
+            row[2] = x + rng.uniform(8.0f, 40.0f);
+            row[3] = y + rng.uniform(8.0f, 40.0f);
+            row[4] = rng.uniform(0.0f, 0.02f);
+            row[5] = float(rng.bounded(spec.numClasses)) + 0.5f;
+        }
+    }
+    return out;
+}
+
+std::string classNamesDict(int numClasses)
+{
+    std::string s = "{";
+    for (int c = 0; c < numClasses; ++c) {
+        if (c > 0) s += ", ";
+        s += std::to_string(c) + ": 'class" + std::to_string(c) + "'";
+    }
+    return s + "}";
+}
+
+} // namespace
+
+const char* onnxFixtureKindName(OnnxFixtureKind kind)
+{
+    switch (kind) {
+    case OnnxFixtureKind::V5:       return "v5";
+    case OnnxFixtureKind::V8:       return "v8";
+    case OnnxFixtureKind::EndToEnd: return "e2e";
+    }
+    return "unknown";
+}
+
+std::vector<int64_t> onnxFixtureOutputShape(const OnnxFixtureSpec& spec)
+{
+    int64_t cells = 0;
+    for (int s : STRIDES)
+        cells += int64_t(spec.inputSize / s) * (spec.inputSize / s);
+
+    switch (spec.kind) {
+    case OnnxFixtureKind::V5:       return { 1, 3 * cells, spec.numClasses + 5 };
+    case OnnxFixtureKind::V8:       return { 1, spec.numClasses + 4, cells };
+    case OnnxFixtureKind::EndToEnd: return { 1, spec.maxDetections, 6 };
+    }
+    return {};
+}
+
+std::string buildOnnxFixture(const OnnxFixtureSpec& spec)
+{
+    Rng rng(spec.seed);
+    const int64_t size = spec.inputSize;
+    const std::vector<PlantedObject> objects = plantObjects(spec, rng);
+
+    // Channels per cell of the head: one V5 row per anchor (3 per cell),
+    // one V8 column per cell; the end-to-end head slices 6 channels off a
+    // V8-style head.
+    int channels = spec.numClasses + 4;
+    if (spec.kind == OnnxFixtureKind::V5)       channels = 3 * (spec.numClasses + 5);
+    if (spec.kind == OnnxFixtureKind::EndToEnd) channels = std::max(channels, 6);
+    const int rowWidth = spec.kind == OnnxFixtureKind::V5 ? spec.numClasses + 5 : channels;
+
+    Graph graph;
+    graph.input(valueInfo("images", { 1, 3, size, size }));
+    graph.initializer(int64Tensor("head_shape", { 1, rowWidth, -1 }));
+
+    std::vector<std::string> levels;
+    for (int s : STRIDES) {
+        const std::string name = "p" + std::to_string(s);
+        // Each output sums 3 * s * s inputs in [0, 1]; keep it below 0.1
+        const float a = 0.1f / float(3 * s * s);
+        std::vector<float> w(size_t(channels) * 3 * s * s);
+        for (float& v : w) v = rng.uniform(-a, a);
+        graph.initializer(floatTensor(name + "_w", { channels, 3, s, s }, w));
+        graph.node("Conv", { "images", name + "_w" }, name + "_conv",
+                   { intsAttribute("kernel_shape", { s, s }), intsAttribute("strides", { s, s }) });
+        graph.node("Reshape", { name + "_conv", "head_shape" }, name + "_flat");
+        levels.push_back(name + "_flat");
+    }
+    graph.node("Concat", levels, "head", { intAttribute("axis", 2) });
+
+    std::string raw = "head";
+    std::vector<float> bias;
+    switch (spec.kind) {
+    case OnnxFixtureKind::V5:
+        graph.node("Transpose", { "head" }, "head_t", { intsAttribute("perm", { 0, 2, 1 }) });
+        raw  = "head_t";
+        bias = v5Bias(spec, rng, objects);
+        break;
+    case OnnxFixtureKind::V8:
+        bias = v8Bias(spec, rng, objects);
+        break;
+    case OnnxFixtureKind::EndToEnd:
+        graph.initializer(int64Tensor("slice_starts", { 0, 0 }));
+        graph.initializer(int64Tensor("slice_ends",   { 6, spec.maxDetections }));
+        graph.initializer(int64Tensor("slice_axes",   { 1, 2 }));
+        graph.node("Slice", { "head", "slice_starts", "slice_ends", "slice_axes" }, "dets");
+        graph.node("Transpose", { "dets" }, "dets_t", { intsAttribute("perm", { 0, 2, 1 }) });
+        raw  = "dets_t";
+        bias = endToEndBias(spec, rng, objects);
+        break;
+    }
+
+    const std::vector<int64_t> outShape = onnxFixtureOutputShape(spec);
+    graph.initializer(floatTensor("planted", outShape, bias));
+    graph.node("Add", { raw, "planted" }, "output0");
+    graph.output(valueInfo("output0", outShape));
+
+    // Metadata as Ultralytics writes it
+    const char* description = "Ultralytics YOLOv8n model (YoloLabel fixture)";
+    if (spec.kind == OnnxFixtureKind::V5)       description = "Ultralytics YOLOv5n model (YoloLabel fixture)";
+    if (spec.kind == OnnxFixtureKind::EndToEnd) description = "Ultralytics YOLO26n model (YoloLabel fixture)";
+    std::vector<std::pair<std::string, std::string>> metadata = {
+        { "description", description },
+        { "author",      "YoloLabel" },
+        { "task",        "detect" },
+        { "stride",      "32" },
+        { "batch",       "1" },
+        { "imgsz",       "[" + std::to_string(size) + ", " + std::to_string(size) + "]" },
+        { "names",       classNamesDict(spec.numClasses) },
+    };
+    if (spec.kind == OnnxFixtureKind::EndToEnd)
+        metadata.push_back({ "end2end", "True" });
+
+    Proto opset;
+    opset.varint(2, 17);
+
+    Proto model;
+    model.varint(1, 8);                 // ir_version
+    model.bytes(2, "yololabel-fixture");
+    model.message(7, graph.build("fixture"));
+    model.message(8, opset);
+    for (const auto& kv : metadata) {
+        Proto entry;
+        entry.bytes(1, kv.first);
+        entry.bytes(2, kv.second);
+        model.message(14, entry);
+    }
+    return model.data();
+}
+
+bool writeOnnxFixture(const std::string& path, const OnnxFixtureSpec& spec, std::string& errorMsg)
+{
+    if (spec.inputSize <= 0 || spec.inputSize % 32 != 0 || spec.numClasses <= 0
+            || spec.maxDetections <= 0) {
+        errorMsg = "Invalid fixture spec";
+        return false;
+    }
+    const std::string model = buildOnnxFixture(spec);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(model.data(), std::streamsize(model.size()))) {
+        errorMsg = "Cannot write " + path;
+        return false;
+    }
+    return true;
+}
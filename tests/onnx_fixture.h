@@ -0,0 +1,46 @@
+#ifndef ONNX_FIXTURE_H
+#define ONNX_FIXTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Writes small, valid ONNX detection models shaped like Ultralytics exports,
+// so YoloDetector can be tested and benchmarked end to end without
+// downloading or exporting real weights. Each model is a patchify Conv per
+// stride (8, 16, 32) over the "images" input, reshaped and concatenated
+// into the usual head layout, plus a constant that plants a fixed set of
+// objects:
+//
+//   V5        output0 [1, 3 * A, C + 5]   A = anchors of all three strides
+//   V8        output0 [1, C + 4, A]
+//   EndToEnd  output0 [1, maxDet, 6]      x1, y1, x2, y2, score, class
+//
+// The convolutions keep Session::Run doing real per-pixel work (their
+// output is scaled down to noise below 0.1), and the metadata matches what
+// Ultralytics writes (task, names, imgsz, stride, end2end, description).
+// Generation is deterministic for a given spec.
+enum class OnnxFixtureKind {
+    V5,
+    V8,
+    EndToEnd
+};
+
+struct OnnxFixtureSpec {
+    OnnxFixtureKind kind = OnnxFixtureKind::V8;
+    int numClasses       = 80;
+    int inputSize        = 640;  // square; must be a multiple of 32
+    int objects          = 20;   // planted objects
+    int maxDetections    = 300;  // EndToEnd rows
+    uint32_t seed        = 1;
+};
+
+// Serialized ModelProto.
+std::string buildOnnxFixture(const OnnxFixtureSpec& spec);
+bool writeOnnxFixture(const std::string& path, const OnnxFixtureSpec& spec, std::string& errorMsg);
+
+// Shape of output0 for the spec, batch included.
+std::vector<int64_t> onnxFixtureOutputShape(const OnnxFixtureSpec& spec);
+const char* onnxFixtureKindName(OnnxFixtureKind kind);
+
+#endif // ONNX_FIXTURE_H
@@ -0,0 +1,94 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "batch_labeler.h"
+
+class TestBatchLabeler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ── listImages ───────────────────────────────────────────────
+    void listImages_filtersAndSortsNaturally()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        for (const char *name : { "img10.jpg", "img2.png", "img1.bmp", "notes.txt", "img3.JPG" }) {
+            QFile f(dir.filePath(name));
+            QVERIFY(f.open(QIODevice::WriteOnly));
+        }
+        const QStringList images = BatchAutoLabeler::listImages(dir.path());
+        QCOMPARE(images, QStringList({ dir.path() + "/img1.bmp", dir.path() + "/img2.png",
+                                       dir.path() + "/img3.JPG", dir.path() + "/img10.jpg" }));
+    }
+
+    // ── shard ────────────────────────────────────────────────────
+    void shard_splitsRoundRobin()
+    {
+        const QStringList all = { "a", "b", "c", "d", "e" };
+        QCOMPARE(BatchAutoLabeler::shard(all, 0, 2), QStringList({ "a", "c", "e" }));
+        QCOMPARE(BatchAutoLabeler::shard(all, 1, 2), QStringList({ "b", "d" }));
+        QCOMPARE(BatchAutoLabeler::shard(all, 0, 1), all);
+    }
+    void shard_shardsCoverEveryImageOnce()
+    {
+        QStringList all;
+        for (int i = 0; i < 37; ++i) all.append(QString::number(i));
+        QStringList joined;
+        for (int k = 0; k < 5; ++k) joined += BatchAutoLabeler::shard(all, k, 5);
+        std::sort(joined.begin(), joined.end());
+        std::sort(all.begin(), all.end());
+        QCOMPARE(joined, all);
+    }
+    void shard_moreShardsThanImages()
+    {
+        QVERIFY(BatchAutoLabeler::shard({ "a" }, 3, 4).isEmpty());
+    }
+
+    // ── labelPathFor ─────────────────────────────────────────────
+    void labelPathFor_replacesLastExtension()
+    {
+        QCOMPARE(BatchAutoLabeler::labelPathFor("/data/a.b/img.1.jpg"), QString("/data/a.b/img.1.txt"));
+    }
+
+    // ── formatLabels ─────────────────────────────────────────────
+    void formatLabels_usesCenterFormat()
+    {
+        std::vector<DetectionResult> dets = { {1, 0.9f, 0.25f, 0.5f, 0.5f, 0.25f} };
+        QCOMPARE(BatchAutoLabeler::formatLabels(dets, 2),
+                 QByteArray("1 0.500000 0.625000 0.500000 0.250000\n"));
+    }
+    void formatLabels_dropsUnknownClasses()
+    {
+        std::vector<DetectionResult> dets = {
+            {-1, 0.9f, 0.1f, 0.1f, 0.2f, 0.2f},
+            {0,  0.9f, 0.1f, 0.1f, 0.2f, 0.2f},
+            {2,  0.9f, 0.1f, 0.1f, 0.2f, 0.2f}
+        };
+        QCOMPARE(BatchAutoLabeler::formatLabels(dets, 2).count('\n'), 1);
+    }
+    void formatLabels_emptyWhenNothingDetected()
+    {
+        QVERIFY(BatchAutoLabeler::formatLabels({}, 80).isEmpty());
+    }
+
+    // ── writeLabelsAtomically ────────────────────────────────────
+    void writeLabelsAtomically_replacesContents()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("img.txt");
+        QVERIFY(BatchAutoLabeler::writeLabelsAtomically(path, "0 0.5 0.5 0.1 0.1\n"));
+        QVERIFY(BatchAutoLabeler::writeLabelsAtomically(path, "1 0.2 0.2 0.1 0.1\n"));
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        QCOMPARE(f.readAll(), QByteArray("1 0.2 0.2 0.1 0.1\n"));
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files), QStringList({ "img.txt" }));
+    }
+    void writeLabelsAtomically_failsForMissingDirectory()
+    {
+        QTemporaryDir dir;
+        QVERIFY(!BatchAutoLabeler::writeLabelsAtomically(dir.filePath("missing/img.txt"), "x"));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestBatchLabeler)
+#include "test_batch_labeler.moc"
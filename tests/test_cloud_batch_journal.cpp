@@ -0,0 +1,96 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "cloud_batch_journal.h"
+
+class TestCloudBatchJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void load_missingFileIsInvalid()
+    {
+        QTemporaryDir dir;
+        CloudBatchJournal journal(dir.filePath("none.journal"));
+        QVERIFY(!journal.load().isValid());
+    }
+    void load_replaysTransitions()
+    {
+        QTemporaryDir dir;
+        CloudBatchJournal journal(dir.filePath("batch.journal"));
+        journal.begin({ "/a.jpg", "/b.jpg", "/c.jpg" }, "cats", { "cat", "dog" });
+        journal.recordSubmitted({ "/a.jpg", "/b.jpg" }, { 7, 8 });
+        journal.recordDone("/a.jpg");
+        journal.close();
+
+        const CloudBatchJournal::State state = journal.load();
+        QVERIFY(state.isValid());
+        QCOMPARE(state.paths, QStringList({ "/a.jpg", "/b.jpg", "/c.jpg" }));
+        QCOMPARE(state.prompt, QString("cats"));
+        QCOMPARE(state.classes, QStringList({ "cat", "dog" }));
+        QCOMPARE(state.submitted.size(), 1);
+        QCOMPARE(state.submitted.first().second, QList<qint64>({ 7, 8 }));
+        QCOMPARE(state.remaining(), QStringList({ "/b.jpg", "/c.jpg" }));
+    }
+    void load_ignoresTornLastRecord()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("batch.journal");
+        CloudBatchJournal journal(path);
+        journal.begin({ "/a.jpg", "/b.jpg" }, "", { "cat" });
+        journal.recordDone("/a.jpg");
+        journal.close();
+
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::Append));
+        f.write("{\"type\":\"done\",\"path\":\"/b.j");   // crash mid-write
+        f.close();
+
+        QCOMPARE(journal.load().remaining(), QStringList({ "/b.jpg" }));
+    }
+    void resume_appendsToExistingRun()
+    {
+        QTemporaryDir dir;
+        CloudBatchJournal journal(dir.filePath("batch.journal"));
+        journal.begin({ "/a.jpg", "/b.jpg" }, "", { "cat" });
+        journal.recordDone("/a.jpg");
+        journal.close();
+
+        journal.resume();
+        journal.recordDone("/b.jpg");
+        journal.close();
+        QVERIFY(!journal.load().isValid());   // nothing left
+    }
+    void recordDone_visibleBeforeSync()
+    {
+        QTemporaryDir dir;
+        CloudBatchJournal journal(dir.filePath("batch.journal"));
+        journal.begin({ "/a.jpg", "/b.jpg" }, "", { "cat" });
+        journal.recordDone("/a.jpg");   // flushed, fsync deferred
+
+        const CloudBatchJournal::State state = journal.load();
+        QVERIFY(state.done.contains("/a.jpg"));
+        QCOMPARE(state.remaining(), QStringList({ "/b.jpg" }));
+    }
+    void finish_removesFile()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("batch.journal");
+        CloudBatchJournal journal(path);
+        journal.begin({ "/a.jpg" }, "", { "cat" });
+        QVERIFY(QFile::exists(path));
+        journal.finish();
+        QVERIFY(!QFile::exists(path));
+    }
+    void begin_replacesPreviousRun()
+    {
+        QTemporaryDir dir;
+        CloudBatchJournal journal(dir.filePath("batch.journal"));
+        journal.begin({ "/a.jpg" }, "", { "cat" });
+        journal.begin({ "/x.jpg", "/y.jpg" }, "", { "cat" });
+        journal.close();
+        QCOMPARE(journal.load().paths, QStringList({ "/x.jpg", "/y.jpg" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCloudBatchJournal)
+#include "test_cloud_batch_journal.moc"
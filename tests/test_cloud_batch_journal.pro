@@ -0,0 +1,7 @@
+QT += core testlib
+QT -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+SOURCES += test_cloud_batch_journal.cpp ../cloud_batch_journal.cpp
+HEADERS += ../cloud_batch_journal.h
+INCLUDEPATH += ..
@@ -1,5 +1,10 @@
 #include <QtTest>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QTimeZone>
+#include <memory>
 #include "cloud_labeler.h"
+#include "mock_job_server.h"
 
 class TestCloudLabeler : public QObject
 {
@@ -70,68 +75,68 @@ private slots:
     // ── filterValidDetections ────────────────────────────────────
     void filterValid_singleValidLine()
     {
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.5 0.5 0.2 0.3\n", 3);
-        QCOMPARE(result, QString("0 0.5 0.5 0.2 0.3\n"));
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n"));
     }
     void filterValid_multipleLines()
     {
-        QString input = "0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n";
-        QString result = CloudAutoLabeler::filterValidDetections(input, 3);
-        QCOMPARE(result, QString("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
+        QByteArray input = "0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n";
+        QByteArray result = CloudAutoLabeler::filterValidDetections(input, 3);
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
     }
     void filterValid_classOutOfRange()
     {
         // class 5 is out of range when numClasses=3
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "5 0.5 0.5 0.2 0.3\n", 3);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_coordOutOfRange()
     {
         // cx = 1.5 is out of [0,1]
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 1.5 0.5 0.2 0.3\n", 3);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_zeroWidth()
     {
         // width = 0.0 is rejected (must be > 0)
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.5 0.5 0.0 0.3\n", 3);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_malformedWrongFieldCount()
     {
         // only 4 fields instead of 5
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.5 0.5 0.2\n", 3);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_nonNumeric()
     {
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 abc 0.5 0.2 0.3\n", 3);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_emptyInput()
     {
-        QString result = CloudAutoLabeler::filterValidDetections("", 3);
-        QCOMPARE(result, QString(""));
+        QByteArray result = CloudAutoLabeler::filterValidDetections("", 3);
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_numClassesZero()
     {
         // numClasses=0 should reject everything
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.5 0.5 0.2 0.3\n", 0);
-        QCOMPARE(result, QString());
+        QCOMPARE(result, QByteArray());
     }
     void filterValid_windowsLineEndings()
     {
         // Windows \r\n line endings should be handled
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.5 0.5 0.2 0.3\r\n1 0.1 0.2 0.3 0.4\r\n", 3);
-        QCOMPARE(result, QString("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
     }
 
     // ── remapWithClassNames ──────────────────────────────────────
@@ -141,44 +146,44 @@ private slots:
         QStringList localNames  = {"car", "person"};
         // server ID 0 = "person" -> local ID 1
         // server ID 1 = "car"    -> local ID 0
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 0.5 0.5 0.2 0.3\n", serverNames, localNames);
-        QCOMPARE(result, QString("1 0.5 0.5 0.2 0.3\n"));
+        QCOMPARE(result, QByteArray("1 0.5 0.5 0.2 0.3\n"));
     }
     void remap_caseInsensitive()
     {
         QStringList serverNames = {"Person", "CAR"};
         QStringList localNames  = {"person", "car"};
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n",
             serverNames, localNames);
-        QCOMPARE(result, QString("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
     }
     void remap_unmatchedDropped()
     {
         QStringList serverNames = {"person", "helicopter"};
         QStringList localNames  = {"person", "car"};
         // server ID 1 = "helicopter" has no local match -> dropped
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n",
             serverNames, localNames);
-        QCOMPARE(result, QString("0 0.5 0.5 0.2 0.3\n"));
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n"));
     }
     void remap_emptyLocalClasses()
     {
         QStringList serverNames = {"person"};
         QStringList localNames;
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 0.5 0.5 0.2 0.3\n", serverNames, localNames);
-        QCOMPARE(result, QString());
+        QCOMPARE(result, QByteArray());
     }
     void remap_trimmedWhitespace()
     {
         QStringList serverNames = {"  person  "};
         QStringList localNames  = {"person"};
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 0.5 0.5 0.2 0.3\n", serverNames, localNames);
-        QCOMPARE(result, QString("0 0.5 0.5 0.2 0.3\n"));
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n"));
     }
     void remap_multipleLinesWithMixed()
     {
@@ -187,54 +192,678 @@ private slots:
         // server 0 = "dog" -> local 1
         // server 1 = "cat" -> local 0
         // server 2 = "bird" -> dropped
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n2 0.8 0.8 0.1 0.1\n",
             serverNames, localNames);
-        QCOMPARE(result, QString("1 0.5 0.5 0.2 0.3\n0 0.1 0.2 0.3 0.4\n"));
+        QCOMPARE(result, QByteArray("1 0.5 0.5 0.2 0.3\n0 0.1 0.2 0.3 0.4\n"));
     }
     void remap_coordValidation()
     {
         // Invalid coords should be filtered even when class name matches
         QStringList serverNames = {"person"};
         QStringList localNames  = {"person"};
-        QString result = CloudAutoLabeler::remapWithClassNames(
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
             "0 1.5 0.5 0.2 0.3\n", serverNames, localNames);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
+    }
+    // ── parseJobResult ──────────────────────────────────────────
+    void parseJobResult_matchesQJsonDocument()
+    {
+        const QString text = QString("0 0.5 0.5 0.2 0.2\n1 \"q\" \\ / \t") + QChar(0x00E9) + QChar(0x4E2D)
+                             + QChar(0xD83D) + QChar(0xDE00) + "\n";
+        const QJsonObject obj{ { "job_id", 7 },
+                               { "meta", QJsonObject{ { "yolo_txt", "nested" }, { "n", QJsonArray{ 1, "]}" } } } },
+                               { "yolo_txt", text },
+                               { "class_names", QJsonArray{ "Person", "car" } },
+                               { "compute_ms", 42 } };
+        for (const auto format : { QJsonDocument::Compact, QJsonDocument::Indented }) {
+            CloudAutoLabeler::JobResult r;
+            QVERIFY(CloudAutoLabeler::parseJobResult(QJsonDocument(obj).toJson(format), r));
+            QCOMPARE(r.yoloTxt, text.toUtf8());
+            QVERIFY(r.hasClassNames);
+            QCOMPARE(r.classNames, QStringList({ "Person", "car" }));
+            QCOMPARE(r.computeMs, 42);
+        }
+    }
+    void parseJobResult_missingFieldsReadAsEmpty()
+    {
+        CloudAutoLabeler::JobResult r;
+        QVERIFY(CloudAutoLabeler::parseJobResult(R"({"yolo_txt": null, "status": "succeeded"})", r));
+        QVERIFY(r.yoloTxt.isEmpty());
+        QVERIFY(!r.hasClassNames);
+        QVERIFY(CloudAutoLabeler::parseJobResult("{}", r));
+    }
+    void parseJobResult_decodesUnicodeEscapes()
+    {
+        // QJsonDocument writes non-ASCII raw, so build the escapes by hand
+        CloudAutoLabeler::JobResult r;
+        QVERIFY(CloudAutoLabeler::parseJobResult(R"({"yolo_txt": "\u00e9\ud83d\ude00\ud83d\n"})", r));
+        QCOMPARE(r.yoloTxt, QByteArray("\xc3\xa9\xf0\x9f\x98\x80\xef\xbf\xbd\n"));   // lone surrogate -> U+FFFD
+    }
+    void parseJobResult_rejectsMalformedReplies()
+    {
+        CloudAutoLabeler::JobResult r;
+        QVERIFY(!CloudAutoLabeler::parseJobResult("", r));
+        QVERIFY(!CloudAutoLabeler::parseJobResult("[1, 2]", r));
+        QVERIFY(!CloudAutoLabeler::parseJobResult(R"({"yolo_txt": "0 0.5)", r));     // truncated
+        QVERIFY(!CloudAutoLabeler::parseJobResult(R"({"yolo_txt": "\x"})", r));      // bad escape
+        QVERIFY(!CloudAutoLabeler::parseJobResult(R"({"yolo_txt" "a"})", r));        // no colon
     }
+
     // ── Edge cases for filterValidDetections ────────────────────
     void filterValid_boundaryCoordZero()
     {
         // cx=0.0, cy=0.0 are valid (lower bound of [0,1])
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.0 0.0 0.5 0.5\n", 3);
-        QCOMPARE(result, QString("0 0.0 0.0 0.5 0.5\n"));
+        QCOMPARE(result, QByteArray("0 0.0 0.0 0.5 0.5\n"));
     }
     void filterValid_boundaryCoordOne()
     {
         // cx=1.0, cy=1.0 are valid (upper bound of [0,1])
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 1.0 1.0 0.5 0.5\n", 3);
-        QCOMPARE(result, QString("0 1.0 1.0 0.5 0.5\n"));
+        QCOMPARE(result, QByteArray("0 1.0 1.0 0.5 0.5\n"));
     }
     void filterValid_widthExactlyOne()
     {
         // w=1.0 is valid (upper bound of (0,1])
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0 0.5 0.5 1.0 1.0\n", 3);
-        QCOMPARE(result, QString("0 0.5 0.5 1.0 1.0\n"));
+        QCOMPARE(result, QByteArray("0 0.5 0.5 1.0 1.0\n"));
     }
     void filterValid_negativeClassId()
     {
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "-1 0.5 0.5 0.2 0.3\n", 3);
-        QCOMPARE(result, QString(""));
+        QCOMPARE(result, QByteArray(""));
     }
     void filterValid_extraWhitespace()
     {
         // Extra spaces between fields — should still parse
-        QString result = CloudAutoLabeler::filterValidDetections(
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
             "0   0.5   0.5   0.2   0.3\n", 3);
-        QCOMPARE(result, QString("0   0.5   0.5   0.2   0.3\n"));
+        QCOMPARE(result, QByteArray("0   0.5   0.5   0.2   0.3\n"));
+    }
+    void filterValid_nonFiniteRejected()
+    {
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
+            "0 nan 0.5 0.2 0.3\n0 0.5 inf 0.2 0.3\n", 3);
+        QCOMPARE(result, QByteArray(""));
+    }
+    void filterValid_lastLineWithoutNewline()
+    {
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
+            "0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4", 3);
+        QCOMPARE(result, QByteArray("0 0.5 0.5 0.2 0.3\n1 0.1 0.2 0.3 0.4\n"));
+    }
+    void filterValid_sixFieldsRejected()
+    {
+        QByteArray result = CloudAutoLabeler::filterValidDetections(
+            "0 0.5 0.5 0.2 0.3 0.9\n", 3);
+        QCOMPARE(result, QByteArray(""));
+    }
+    void remap_serverIdOutOfRangeDropped()
+    {
+        QByteArray result = CloudAutoLabeler::remapWithClassNames(
+            "3 0.5 0.5 0.2 0.3\n-1 0.5 0.5 0.2 0.3\n", {"person"}, {"person"});
+        QCOMPARE(result, QByteArray(""));
+    }
+
+    // ── Poll scheduling ─────────────────────────────────────────
+    void nextPollDelay_startsShortAndCaps()
+    {
+        for (int k = 0; k < 50; ++k) {
+            const int first = CloudAutoLabeler::nextPollDelay(0);
+            QVERIFY(first >= CloudAutoLabeler::INITIAL_POLL_INTERVAL * 0.8 - 1);
+            QVERIFY(first <= CloudAutoLabeler::INITIAL_POLL_INTERVAL * 1.2 + 1);
+
+            const int late = CloudAutoLabeler::nextPollDelay(30);
+            QVERIFY(late <= CloudAutoLabeler::MAX_POLL_INTERVAL);
+            QVERIFY(late >= CloudAutoLabeler::MAX_POLL_INTERVAL * 0.8 - 1);
+        }
+    }
+    void parseRetryAfter_seconds()
+    {
+        QCOMPARE(CloudAutoLabeler::parseRetryAfter("3", QDateTime::currentDateTimeUtc()), 3000);
+    }
+    void parseRetryAfter_httpDate()
+    {
+        const QDateTime now = QDateTime(QDate(2024, 1, 1), QTime(12, 0, 0), QTimeZone::utc());
+        QCOMPARE(CloudAutoLabeler::parseRetryAfter("Mon, 01 Jan 2024 12:00:05 GMT", now), 5000);
+    }
+    void parseRetryAfter_invalid()
+    {
+        QCOMPARE(CloudAutoLabeler::parseRetryAfter("", QDateTime::currentDateTimeUtc()), -1);
+        QCOMPARE(CloudAutoLabeler::parseRetryAfter("soon", QDateTime::currentDateTimeUtc()), -1);
+    }
+
+    void batch_fastJobsNotHeldBackBySlowOne()
+    {
+        MockJobServer server;
+        server.latenciesMs = { 100, 100, 2500 };
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 3);
+
+        auto labeler = makeLabeler(server);
+
+        QSignalSpy ready(labeler.get(), &CloudAutoLabeler::labelReady);
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+
+        // Fast jobs land well before the slow one finishes
+        QTRY_VERIFY_WITH_TIMEOUT(ready.count() >= 2, 1500);
+        QCOMPARE(finished.count(), 0);
+
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+        QCOMPARE(finished.first().first().toInt(), 3);
+        for (const QString &p : paths)
+            QVERIFY(QFile::exists(CloudAutoLabeler::labelPathFor(p)));
+
+        // Backoff keeps the slow job from being hammered
+        QVERIFY(server.pollsPerJob.value(3) <= 8);
+    }
+    void batch_honorsRetryAfter()
+    {
+        MockJobServer server;
+        server.latenciesMs      = { 0, 0 };
+        server.rateLimitedPolls = 1;
+        server.retryAfterSec    = 1;
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 2);
+
+        auto labeler = makeLabeler(server);
+
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+        QCOMPARE(finished.first().first().toInt(), 2);
+
+        // The 429 pauses all polling: no other poll until Retry-After elapses
+        QVERIFY(server.pollTimes.size() >= 2);
+        const qint64 limitedAt = server.pollTimes.first();
+        for (int k = 1; k < server.pollTimes.size(); ++k) {
+            // A sibling poll may already be on the wire when the 429 is sent
+            const qint64 dt = server.pollTimes[k] - limitedAt;
+            QVERIFY(dt < 50 || dt >= 900);
+        }
+    }
+
+    void single_labelsThroughJobEndpoints()
+    {
+        MockJobServer server;
+        server.latenciesMs = { 600 };
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 1);
+
+        auto labeler = makeLabeler(server);
+
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImage(paths.first());
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+
+        QVERIFY(QFile::exists(CloudAutoLabeler::labelPathFor(paths.first())));
+        QCOMPARE(server.requestCounts.value("POST /v1/jobs"), 1);
+        QCOMPARE(server.requestCounts.value("GET /v1/jobs/{id}/result"), 1);
+        QVERIFY(server.requestCounts.value("GET /v1/jobs/{id}") >= 2);
+    }
+    // ── Upload preparation ──────────────────────────────────────
+    void prepareUpload_downscalesLargeImage()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("big.png");
+        QImage img(3000, 2000, QImage::Format_RGB32);
+        for (int y = 0; y < img.height(); ++y)
+            for (int x = 0; x < img.width(); ++x)
+                img.setPixel(x, y, qRgb(x & 0xff, y & 0xff, (x ^ y) & 0xff));
+        QVERIFY(img.save(path));
+
+        const auto prepared = CloudAutoLabeler::prepareUpload(path, 1024, 90, "jpg");
+        QVERIFY(!prepared.bytes.isEmpty());
+        QVERIFY(prepared.bytes.size() < QFileInfo(path).size());
+        QCOMPARE(prepared.mime, QByteArray("image/jpeg"));
+        QCOMPARE(prepared.fileName, QString("big.jpg"));
+
+        const QImage decoded = QImage::fromData(prepared.bytes, "JPG");
+        QCOMPARE(decoded.size(), QSize(1024, 682));
+    }
+    void prepareUpload_keepsSmallJpeg()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("small.jpg");
+        QImage img(200, 100, QImage::Format_RGB32);
+        img.fill(Qt::darkGreen);
+        QVERIFY(img.save(path));
+
+        const auto prepared = CloudAutoLabeler::prepareUpload(path, 1024, 90, "jpg");
+        QVERIFY(prepared.bytes.isEmpty());   // original file is uploaded
+        QCOMPARE(prepared.fileSize, QFileInfo(path).size());
+    }
+    void prepareUpload_unreadableFallsBackToOriginal()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 1);
+        QVERIFY(CloudAutoLabeler::prepareUpload(paths.first(), 1024, 90, "jpg").bytes.isEmpty());
+    }
+
+    // ── Result cache ────────────────────────────────────────────
+    void batch_rerunResolvedFromResultCache()
+    {
+        MockJobServer server;
+        server.latenciesMs = { 0, 0, 0 };
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir, cacheDir;
+        QVERIFY(dir.isValid() && cacheDir.isValid());
+        QStringList paths = writeImages(dir, 2);
+
+        auto labeler = makeLabeler(server);
+        labeler->setResultCacheDirectory(cacheDir.path());
+
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+        QCOMPARE(server.batchSubmits, 1);
+
+        // Same images plus a new one: only the new one goes to the server
+        QFile f(dir.filePath("img9.jpg"));
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write("a different image");
+        f.close();
+        paths.append(f.fileName());
+        QFile::remove(CloudAutoLabeler::labelPathFor(paths.first()));
+
+        QSignalSpy ready(labeler.get(), &CloudAutoLabeler::labelReady);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 2, 10000);
+        QCOMPARE(finished.last().first().toInt(), 3);
+        QCOMPARE(ready.count(), 3);
+        QCOMPARE(server.batchSubmits, 2);
+        QCOMPARE(server.pollsPerJob.size(), 3);   // 2 from the first run, 1 new
+        QVERIFY(QFile::exists(CloudAutoLabeler::labelPathFor(paths.first())));
+    }
+    void batch_promptChangeMissesResultCache()
+    {
+        MockJobServer server;
+        server.latenciesMs = { 0, 0, 0, 0 };
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir, cacheDir;
+        QVERIFY(dir.isValid() && cacheDir.isValid());
+        const QStringList paths = writeImages(dir, 2);
+
+        auto labeler = makeLabeler(server);
+        labeler->setResultCacheDirectory(cacheDir.path());
+
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+
+        labeler->setPrompt("something else");
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 2, 10000);
+        QCOMPARE(server.batchSubmits, 2);
+    }
+    void batch_overwrittenLabelsGoToSnapshotPack()
+    {
+        MockJobServer server;
+        server.latenciesMs = { 0, 0 };
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir, snapDir;
+        QVERIFY(dir.isValid() && snapDir.isValid());
+        const QStringList paths = writeImages(dir, 2);
+        const QString oldLabel = CloudAutoLabeler::labelPathFor(paths[0]);
+        {
+            QFile f(oldLabel);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write("0 0.1 0.1 0.1 0.1\n");
+        }
+
+        auto labeler = makeLabeler(server);
+        labeler->setSnapshotDirectory(snapDir.path());
+
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+        QTRY_VERIFY_WITH_TIMEOUT(!labeler->isBusy(), 1000);
+
+        QVERIFY(!QFile::exists(oldLabel + ".bak"));
+        const auto runs = labeler->snapshotRuns();
+        QCOMPARE(runs.size(), 1);
+        QCOMPARE(runs.first().labels, 2);
+
+        QCOMPARE(LabelSnapshotStore::restore(runs.first().packPath), 2);
+        QFile f(oldLabel);
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        QCOMPARE(f.readAll(), QByteArray("0 0.1 0.1 0.1 0.1\n"));
+        QVERIFY(!QFile::exists(CloudAutoLabeler::labelPathFor(paths[1])));
+    }
+
+    // ── Priority lane ───────────────────────────────────────────
+    void prioritize_movesUnsubmittedImagesToFrontChunk()
+    {
+        CloudAutoLabeler labeler;
+        labeler.m_busy      = true;
+        labeler.m_batchMode = true;
+        labeler.m_batchPending = { "/a", "/b", "/c", "/d", "/e" };
+
+        labeler.prioritize({ "/d", "/e", "/x" });   // /x is not pending
+        QCOMPARE(labeler.m_batchPending, QStringList({ "/d", "/e", "/a", "/b", "/c" }));
+
+        // The lane is cut as a chunk of its own
+        QCOMPARE(labeler.takeNextChunk(), QStringList({ "/d", "/e" }));
+    }
+    void prioritize_ignoredWhenIdle()
+    {
+        CloudAutoLabeler labeler;
+        labeler.m_batchPending = { "/a", "/b" };
+        labeler.prioritize({ "/b" });
+        QCOMPARE(labeler.m_batchPending, QStringList({ "/a", "/b" }));
+    }
+
+    void keepUserLabel_resultDoesNotOverwriteHandSavedLabel()
+    {
+        MockJobServer server;
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 2);
+        const QString userLabel = CloudAutoLabeler::labelPathFor(paths[0]);
+
+        auto labeler = makeLabeler(server);
+        QSignalSpy ready(labeler.get(), &CloudAutoLabeler::labelReady);
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        {
+            QFile f(userLabel);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write("0 0.5 0.5 0.1 0.1\n");
+        }
+        labeler->keepUserLabel(paths[0]);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+
+        QCOMPARE(finished.first().first().toInt(), 2);   // still counted as done
+        QCOMPARE(ready.count(), 1);
+        QCOMPARE(ready.first().first().toString(), paths[1]);
+        QFile f(userLabel);
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        QCOMPARE(f.readAll(), QByteArray("0 0.5 0.5 0.1 0.1\n"));
+    }
+
+    // ── Adaptive chunking ───────────────────────────────────────
+    void takeNextChunk_fillsByteBudget()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QStringList paths;
+        for (int k = 0; k < 5; ++k) {
+            const QString p = dir.filePath(QString("img%1.jpg").arg(k));
+            QFile f(p);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write(QByteArray(300 * 1000, 'x'));
+            paths.append(p);
+        }
+
+        CloudAutoLabeler labeler;
+        labeler.m_batchPending      = paths;
+        labeler.m_uploadBytesPerSec = 1000.0 * 1000 / CloudAutoLabeler::TARGET_CHUNK_SECONDS;  // 1 MB budget
+
+        QCOMPARE(labeler.takeNextChunk().size(), 3);
+        QCOMPARE(labeler.takeNextChunk().size(), 2);
+        QVERIFY(labeler.m_batchPending.isEmpty());
+    }
+    void takeNextChunk_alwaysTakesOneOversizedImage()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString p = dir.filePath("huge.jpg");
+        QFile f(p);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write(QByteArray(2 * 1024 * 1024, 'x'));
+        f.close();
+
+        CloudAutoLabeler labeler;
+        labeler.m_batchPending      = { p, p + "-missing" };
+        labeler.m_uploadBytesPerSec = CloudAutoLabeler::MIN_UPLOAD_BPS;
+        QCOMPARE(labeler.takeNextChunk(), QStringList({ p }));
+    }
+    void takeNextChunk_capsImageCount()
+    {
+        CloudAutoLabeler labeler;
+        for (int k = 0; k < CloudAutoLabeler::BATCH_SIZE + 5; ++k)
+            labeler.m_batchPending.append(QString("/missing/%1.jpg").arg(k));   // 0 bytes
+        QCOMPARE(labeler.takeNextChunk().size(), CloudAutoLabeler::BATCH_SIZE);
+    }
+    void batch_failedChunkIsSplit()
+    {
+        MockJobServer server;
+        server.maxBatchImages = 2;
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 5);
+
+        auto labeler = makeLabeler(server);
+
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 15000);
+        QCOMPARE(finished.first().first().toInt(), 5);
+
+        int accepted = 0;
+        for (int n : std::as_const(server.acceptedBatchSizes)) {
+            QVERIFY(n <= 2);
+            accepted += n;
+        }
+        QCOMPARE(accepted, 5);   // every image uploaded exactly once successfully
+    }
+    void batch_rejectedSubmitFailsFast()
+    {
+        MockJobServer server;
+        server.submitStatus = 401;
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 4);
+
+        auto labeler = makeLabeler(server);
+        const double bps = labeler->m_uploadBytesPerSec;
+
+        QSignalSpy error(labeler.get(), &CloudAutoLabeler::errorOccurred);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(error.count(), 1, 10000);
+        QCOMPARE(server.batchSubmits, 1);               // no split, no retries
+        QCOMPARE(labeler->m_uploadBytesPerSec, bps);
+    }
+    void batch_rateLimitedSubmitWaitsForRetryAfter()
+    {
+        MockJobServer server;
+        server.rateLimitedSubmits = 1;
+        server.retryAfterSec      = 1;
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 4);
+
+        auto labeler = makeLabeler(server);
+
+        QElapsedTimer timer;
+        timer.start();
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->labelImages(paths);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+        QVERIFY(timer.elapsed() >= 900);
+        QCOMPARE(finished.first().first().toInt(), 4);
+        QCOMPARE(server.batchSubmits, 2);
+        QCOMPARE(server.acceptedBatchSizes, QList<int>({ 4 }));   // resent whole, not split
+    }
+
+    // ── Journal / resume ────────────────────────────────────────
+    void resume_pollsSubmittedJobsAndSubmitsTheRest()
+    {
+        MockJobServer server;   // unknown job IDs report "succeeded"
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 3);
+        const QString journalPath = dir.filePath("batch.journal");
+
+        // A previous run submitted the first two images, then wrote one label
+        {
+            CloudBatchJournal journal(journalPath);
+            journal.begin(paths, "", { "a" });
+            journal.recordSubmitted(paths.mid(0, 2), { 101, 102 });
+            journal.recordDone(paths[0]);
+        }
+
+        auto labeler = makeLabeler(server);
+        labeler->setJournalPath(journalPath);
+        QVERIFY(labeler->resumableBatch().isValid());
+        QCOMPARE(labeler->resumableBatch().remaining().size(), 2);
+
+        QSignalSpy ready(labeler.get(), &CloudAutoLabeler::labelReady);
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->resumeBatch();
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+
+        QCOMPARE(finished.first().first().toInt(), 3);
+        QCOMPARE(ready.count(), 2);
+        QCOMPARE(server.batchSubmits, 1);               // only the never-submitted image
+        QVERIFY(!server.pollsPerJob.contains(101));     // already labeled
+        QVERIFY(server.pollsPerJob.contains(102));      // picked up from the journal
+        QVERIFY(!QFile::exists(journalPath));           // run completed
+        QVERIFY(!labeler->resumableBatch().isValid());
+    }
+    void resume_journaledChunksFinishingFirstKeepTheRunAlive()
+    {
+        MockJobServer server;
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 3);
+        const QString journalPath = dir.filePath("batch.journal");
+        {
+            CloudBatchJournal journal(journalPath);
+            journal.begin(paths, "", { "a" });
+            journal.recordSubmitted(paths.mid(0, 1), { 101 });
+        }
+
+        auto labeler = makeLabeler(server);
+        labeler->setJournalPath(journalPath);
+        labeler->setResultCacheDirectory(dir.filePath("cache"));
+
+        // Hold the pool so hashing the unsubmitted images cannot finish
+        // until the journaled job has been labeled
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore   gate;
+        const int    blockers = pool->maxThreadCount();
+        for (int k = 0; k < blockers; ++k)
+            pool->start([&gate]() { gate.acquire(); });
+
+        QSignalSpy ready(labeler.get(), &CloudAutoLabeler::labelReady);
+        QSignalSpy finished(labeler.get(), &CloudAutoLabeler::finished);
+        labeler->resumeBatch();
+        QTRY_COMPARE_WITH_TIMEOUT(ready.count(), 1, 10000);
+        QTest::qWait(200);
+        QCOMPARE(finished.count(), 0);
+        QVERIFY(labeler->isBusy());
+        QVERIFY(QFile::exists(journalPath));
+
+        gate.release(blockers);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 10000);
+        QCOMPARE(finished.first().first().toInt(), 3);
+        QCOMPARE(ready.count(), 3);
+        QCOMPARE(server.batchSubmits, 1);
+        QVERIFY(!QFile::exists(journalPath));
+    }
+    void resume_journaledChunksShareTheWindow()
+    {
+        CloudAutoLabeler labeler;
+        labeler.m_batchMode         = true;
+        labeler.m_batchUploading    = true;   // keep new chunks out of the way
+        labeler.m_maxChunksInFlight = 2;
+        for (int k = 0; k < 3; ++k) {
+            auto chunk = std::make_shared<CloudAutoLabeler::BatchChunk>();
+            chunk->paths  = { QString("/img%1.jpg").arg(k) };
+            chunk->jobIds = { 100 + k };
+            labeler.m_resumedChunks.append(chunk);
+        }
+
+        labeler.fillBatchWindow();
+        QCOMPARE(labeler.m_activeChunks.size(), 2);
+        QCOMPARE(labeler.m_resumedChunks.size(), 1);
+
+        labeler.completeBatchChunk(labeler.m_activeChunks.first());
+        QCOMPARE(labeler.m_activeChunks.size(), 2);
+        QVERIFY(labeler.m_resumedChunks.isEmpty());
+    }
+    void cancel_discardsJournal()
+    {
+        MockJobServer server;
+        server.latenciesMs = { 5000, 5000 };
+        QVERIFY(server.listen());
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QStringList paths = writeImages(dir, 2);
+        const QString journalPath = dir.filePath("batch.journal");
+
+        auto labeler = makeLabeler(server);
+        labeler->setJournalPath(journalPath);
+
+        labeler->labelImages(paths);
+        QTRY_VERIFY_WITH_TIMEOUT(!server.pollsPerJob.isEmpty(), 5000);
+        QVERIFY(labeler->resumableBatch().isValid());
+
+        labeler->cancel();
+        QVERIFY(!labeler->resumableBatch().isValid());
+    }
+
+private:
+    // A labeler pointed at the mock server with every on-disk store off;
+    // tests switch on the cache, journal or snapshots they exercise.
+    static std::unique_ptr<CloudAutoLabeler> makeLabeler(const MockJobServer &server)
+    {
+        auto labeler = std::make_unique<CloudAutoLabeler>();
+        labeler->setApiHost(server.url());
+        labeler->setApiKey("test");
+        labeler->setClasses({ "a" });
+        labeler->setResultCacheDirectory(QString());
+        labeler->setJournalPath(QString());
+        labeler->setSnapshotDirectory(QString());
+        return labeler;
+    }
+
+    static QStringList writeImages(const QTemporaryDir &dir, int n)
+    {
+        QStringList paths;
+        for (int k = 0; k < n; ++k) {
+            const QString p = dir.filePath(QString("img%1.jpg").arg(k));
+            QFile f(p);
+            f.open(QIODevice::WriteOnly);
+            f.write("not really a jpeg");
+            paths.append(p);
+        }
+        return paths;
     }
 };
 
@@ -1,8 +1,7 @@
-QT += core network testlib
-QT -= gui
+QT += core gui network testlib
 CONFIG += c++17 console testcase
 CONFIG -= app_bundle
 DEFINES += UNIT_TEST
-SOURCES += test_cloud_labeler.cpp ../cloud_labeler.cpp
-HEADERS += ../cloud_labeler.h
+SOURCES += test_cloud_labeler.cpp mock_job_server.cpp ../cloud_labeler.cpp ../cloud_result_cache.cpp ../cloud_batch_journal.cpp ../label_snapshot_store.cpp
+HEADERS += mock_job_server.h ../cloud_labeler.h ../cloud_result_cache.h ../cloud_batch_journal.h ../label_snapshot_store.h
 INCLUDEPATH += ..
@@ -0,0 +1,123 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "cloud_result_cache.h"
+
+class TestCloudResultCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString writeFile(const QTemporaryDir &dir, const QString &name, const QByteArray &data)
+    {
+        QString path = dir.path() + "/" + name;
+        QFile f(path);
+        f.open(QIODevice::WriteOnly);
+        f.write(data);
+        return path;
+    }
+
+private slots:
+    // ── contentHash ──────────────────────────────────────────────
+    void contentHash_missingFileIsEmpty()
+    {
+        QVERIFY(CloudResultCache::contentHash("/nonexistent/image.jpg").isEmpty());
+    }
+    void contentHash_dependsOnContentNotName()
+    {
+        QTemporaryDir dir;
+        const QString a = writeFile(dir, "a.jpg", "same bytes");
+        const QString b = writeFile(dir, "b.jpg", "same bytes");
+        const QString c = writeFile(dir, "c.jpg", "other bytes");
+        QCOMPARE(CloudResultCache::contentHash(a), CloudResultCache::contentHash(b));
+        QVERIFY(CloudResultCache::contentHash(a) != CloudResultCache::contentHash(c));
+    }
+
+    // ── key ──────────────────────────────────────────────────────
+    void key_emptyWithoutContentHash()
+    {
+        QVERIFY(CloudResultCache::key(QByteArray(), "prompt", { "a" }).isEmpty());
+    }
+    void key_changesWithPromptAndClasses()
+    {
+        const QByteArray h = QByteArray(32, 'x');
+        const QByteArray base = CloudResultCache::key(h, "p", { "a", "b" });
+        QCOMPARE(CloudResultCache::key(h, "p", { "a", "b" }), base);
+        QVERIFY(CloudResultCache::key(h, "q", { "a", "b" }) != base);
+        QVERIFY(CloudResultCache::key(h, "p", { "b", "a" }) != base);
+        QVERIFY(CloudResultCache::key(h, "p", { "a" }) != base);
+    }
+    void key_fieldBoundariesAreUnambiguous()
+    {
+        const QByteArray h = QByteArray(32, 'x');
+        QVERIFY(CloudResultCache::key(h, "", { "ab", "c" })
+                != CloudResultCache::key(h, "", { "a", "bc" }));
+    }
+
+    // ── lookup / store ───────────────────────────────────────────
+    void store_roundTripsYoloTxtAndClassNames()
+    {
+        QTemporaryDir dir;
+        CloudResultCache cache(dir.path());
+        const QByteArray key = CloudResultCache::key(QByteArray(32, 'x'), "p", { "a" });
+
+        QJsonObject result;
+        result["yolo_txt"]    = "0 0.5 0.5 0.2 0.2\n";
+        result["class_names"] = QJsonArray{ "a" };
+        result["compute_ms"]  = 42;
+        cache.store(key, result);
+
+        QJsonObject out;
+        QVERIFY(cache.lookup(key, out));
+        QCOMPARE(out.value("yolo_txt").toString(), QString("0 0.5 0.5 0.2 0.2\n"));
+        QCOMPARE(out.value("class_names").toArray().size(), 1);
+        QVERIFY(!out.contains("compute_ms"));
+    }
+    void lookup_missReturnsFalse()
+    {
+        QTemporaryDir dir;
+        CloudResultCache cache(dir.path());
+        QJsonObject out;
+        QVERIFY(!cache.lookup(CloudResultCache::key(QByteArray(32, 'y'), "p", {}), out));
+    }
+    void disabled_neverStoresOrHits()
+    {
+        CloudResultCache cache{QString()};
+        QVERIFY(!cache.isEnabled());
+        const QByteArray key = CloudResultCache::key(QByteArray(32, 'x'), "p", { "a" });
+        cache.store(key, QJsonObject{{ "yolo_txt", "" }});
+        QJsonObject out;
+        QVERIFY(!cache.lookup(key, out));
+    }
+
+    // ── prune ────────────────────────────────────────────────────
+    void prune_dropsLeastRecentlyUsedFirst()
+    {
+        QTemporaryDir dir;
+        QJsonObject result{ { "yolo_txt", QString(200, 'x') } };
+        QList<QByteArray> keys;
+        for (int k = 0; k < 4; ++k) {
+            keys.append(CloudResultCache::key(QByteArray(32, char('a' + k)), "p", { "a" }));
+            CloudResultCache(dir.path()).store(keys.last(), result);
+        }
+        // Age every entry, oldest first, then touch the oldest with a hit
+        const QDateTime base = QDateTime::currentDateTimeUtc().addSecs(-3600);
+        for (int k = 0; k < keys.size(); ++k) {
+            QFile f(dir.path() + '/' + keys[k].left(2) + '/' + keys[k] + ".json");
+            QVERIFY(f.open(QIODevice::ReadWrite));
+            QVERIFY(f.setFileTime(base.addSecs(k * 60), QFileDevice::FileModificationTime));
+        }
+        const qint64 entrySize = QFileInfo(dir.path() + '/' + keys[0].left(2) + '/' + keys[0] + ".json").size();
+        CloudResultCache cache(dir.path(), entrySize * 2);
+        QJsonObject out;
+        QVERIFY(cache.lookup(keys[0], out));
+
+        cache.prune();
+        QVERIFY(cache.lookup(keys[0], out));    // recently hit
+        QVERIFY(!cache.lookup(keys[1], out));
+        QVERIFY(!cache.lookup(keys[2], out));
+        QVERIFY(cache.lookup(keys[3], out));    // most recently stored
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCloudResultCache)
+#include "test_cloud_result_cache.moc"
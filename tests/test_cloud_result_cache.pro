@@ -0,0 +1,7 @@
+QT += core testlib
+QT -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+SOURCES += test_cloud_result_cache.cpp ../cloud_result_cache.cpp
+HEADERS += ../cloud_result_cache.h
+INCLUDEPATH += ..
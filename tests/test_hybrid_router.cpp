@@ -0,0 +1,85 @@
+#include <QtTest>
+#include "hybrid_router.h"
+
+class TestHybridRouter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ── route ────────────────────────────────────────────────────
+    void route_confidentImageStaysLocal()
+    {
+        std::vector<DetectionResult> dets = {
+            {0, 0.9f, 0.1f, 0.1f, 0.2f, 0.2f},
+            {1, 0.4f, 0.6f, 0.6f, 0.2f, 0.2f}
+        };
+        QCOMPARE(HybridRouter::route(dets, RoutingThresholds()), HybridRouter::Decision::Local);
+    }
+    void route_noDetectionsGoesToCloud()
+    {
+        QCOMPARE(HybridRouter::route({}, RoutingThresholds()),
+                 HybridRouter::Decision::FewDetections);
+    }
+    void route_minDetectionsZeroAcceptsEmptyImage()
+    {
+        RoutingThresholds t;
+        t.minDetections = 0;
+        QCOMPARE(HybridRouter::route({}, t), HybridRouter::Decision::Local);
+    }
+    void route_lowTopConfidenceGoesToCloud()
+    {
+        std::vector<DetectionResult> dets = {
+            {0, 0.30f, 0.1f, 0.1f, 0.2f, 0.2f},
+            {0, 0.45f, 0.6f, 0.6f, 0.2f, 0.2f}
+        };
+        QCOMPARE(HybridRouter::route(dets, RoutingThresholds()),
+                 HybridRouter::Decision::LowConfidence);
+    }
+    void route_classDisagreementGoesToCloud()
+    {
+        // Same object reported as two classes
+        std::vector<DetectionResult> dets = {
+            {0, 0.9f, 0.1f, 0.1f, 0.4f, 0.4f},
+            {1, 0.8f, 0.1f, 0.1f, 0.4f, 0.4f}
+        };
+        QCOMPARE(HybridRouter::route(dets, RoutingThresholds()),
+                 HybridRouter::Decision::Disagreement);
+    }
+
+    // ── disagreement ─────────────────────────────────────────────
+    void disagreement_empty()
+    {
+        QCOMPARE(HybridRouter::disagreement({}, 0.5f), 0.0f);
+    }
+    void disagreement_sameClassOverlapIgnored()
+    {
+        std::vector<DetectionResult> dets = {
+            {0, 0.9f, 0.1f, 0.1f, 0.4f, 0.4f},
+            {0, 0.8f, 0.1f, 0.1f, 0.4f, 0.4f}
+        };
+        QCOMPARE(HybridRouter::disagreement(dets, 0.5f), 0.0f);
+    }
+    void disagreement_countsContestedBoxes()
+    {
+        // Two of four boxes contest each other; the rest are separate objects
+        std::vector<DetectionResult> dets = {
+            {0, 0.9f, 0.0f, 0.0f, 0.2f, 0.2f},
+            {1, 0.8f, 0.0f, 0.0f, 0.2f, 0.2f},
+            {0, 0.9f, 0.5f, 0.5f, 0.2f, 0.2f},
+            {1, 0.9f, 0.8f, 0.0f, 0.1f, 0.1f}
+        };
+        QCOMPARE(HybridRouter::disagreement(dets, 0.5f), 0.5f);
+    }
+    void disagreement_belowIouThresholdIgnored()
+    {
+        // IoU = 1/7, well below 0.5
+        std::vector<DetectionResult> dets = {
+            {0, 0.9f, 0.0f, 0.0f, 0.4f, 0.4f},
+            {1, 0.8f, 0.2f, 0.2f, 0.4f, 0.4f}
+        };
+        QCOMPARE(HybridRouter::disagreement(dets, 0.5f), 0.0f);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestHybridRouter)
+#include "test_hybrid_router.moc"
@@ -0,0 +1,123 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include "image_cache.h"
+
+class TestImageCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString writeImage(const QTemporaryDir &dir, const QString &name, int w, int h, QColor color)
+    {
+        QString path = dir.path() + "/" + name;
+        QImage img(w, h, QImage::Format_RGB888);
+        img.fill(color);
+        img.save(path);
+        return path;
+    }
+
+private slots:
+    void init()
+    {
+        ImageCache::instance().clear();
+        ImageCache::instance().setByteBudget(ImageCache::DEFAULT_BYTE_BUDGET);
+    }
+
+    // ── load ─────────────────────────────────────────────────────
+    void load_missingFileReturnsNull()
+    {
+        QVERIFY(ImageCache::instance().load("/nonexistent/image.png").isNull());
+        QCOMPARE(ImageCache::instance().bytesUsed(), qint64(0));
+    }
+    void load_secondLoadSharesBuffer()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = writeImage(tmpDir, "a.png", 32, 16, Qt::red);
+
+        QImage first  = ImageCache::instance().load(path);
+        QImage second = ImageCache::instance().load(path);
+        QVERIFY(!first.isNull());
+        QCOMPARE(first.size(), QSize(32, 16));
+        // Implicitly shared — same buffer, no second decode
+        QCOMPARE(second.cacheKey(), first.cacheKey());
+        QCOMPARE(ImageCache::instance().bytesUsed(), first.sizeInBytes());
+    }
+    void load_reloadsWhenFileChanges()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = writeImage(tmpDir, "a.png", 32, 16, Qt::red);
+
+        QImage before = ImageCache::instance().load(path);
+        writeImage(tmpDir, "a.png", 64, 64, Qt::blue);
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::ReadWrite));
+        QVERIFY(f.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+        f.close();
+
+        QImage after = ImageCache::instance().load(path);
+        QCOMPARE(after.size(), QSize(64, 64));
+        QVERIFY(after.cacheKey() != before.cacheKey());
+    }
+
+    void peek_doesNotDecode()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = writeImage(tmpDir, "a.png", 32, 16, Qt::red);
+
+        QVERIFY(ImageCache::instance().peek(path).isNull());
+        QImage loaded = ImageCache::instance().load(path);
+        QCOMPARE(ImageCache::instance().peek(path).cacheKey(), loaded.cacheKey());
+    }
+
+    // ── byte budget ──────────────────────────────────────────────
+    void budget_evictsLeastRecentlyUsed()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString a = writeImage(tmpDir, "a.png", 64, 64, Qt::red);
+        QString b = writeImage(tmpDir, "b.png", 64, 64, Qt::green);
+
+        qint64 oneImage = ImageCache::instance().load(a).sizeInBytes();
+        ImageCache::instance().clear();
+        ImageCache::instance().setByteBudget(oneImage + oneImage / 2);
+
+        QImage imgA = ImageCache::instance().load(a);
+        ImageCache::instance().load(b);
+        QVERIFY(ImageCache::instance().bytesUsed() <= ImageCache::instance().byteBudget());
+
+        // a was evicted by b, so it is decoded again
+        QVERIFY(ImageCache::instance().load(a).cacheKey() != imgA.cacheKey());
+    }
+    void budget_oversizedImageNotCached()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString a = writeImage(tmpDir, "a.png", 64, 64, Qt::red);
+
+        ImageCache::instance().setByteBudget(16);
+        QVERIFY(!ImageCache::instance().load(a).isNull());
+        QCOMPARE(ImageCache::instance().bytesUsed(), qint64(0));
+    }
+
+    // ── prefetch ─────────────────────────────────────────────────
+    void prefetch_populatesCache()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString a = writeImage(tmpDir, "a.png", 32, 32, Qt::red);
+
+        ImageCache::instance().prefetch(a);
+        QThreadPool::globalInstance()->waitForDone();
+        QVERIFY(ImageCache::instance().bytesUsed() > 0);
+
+        QImage img = ImageCache::instance().load(a);
+        QCOMPARE(img.size(), QSize(32, 32));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestImageCache)
+#include "test_image_cache.moc"
@@ -0,0 +1,6 @@
+QT += core gui testlib
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+SOURCES += test_image_cache.cpp ../image_cache.cpp
+HEADERS += ../image_cache.h
+INCLUDEPATH += ..
@@ -67,6 +67,16 @@ int main(int argc, char* argv[])
     }
     root["detections"] = detsArray;
 
+    const DetectorStageTimes& t = detector.getStats().last();
+    QJsonObject timings;
+    timings["preprocessMs"] = t.preprocessMs;
+    timings["runMs"] = t.runMs;
+    timings["postprocessMs"] = t.postprocessMs;
+    timings["nmsMs"] = t.nmsMs;
+    timings["candidates"] = t.candidates;
+    timings["kept"] = t.kept;
+    root["timings"] = timings;
+
     QJsonDocument doc(root);
     std::cout << doc.toJson(QJsonDocument::Indented).toStdString();
 
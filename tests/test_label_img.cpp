@@ -666,6 +666,64 @@ private slots:
         widget.init();
         widget.setContrastGamma(3.0f);
     }
+    void gamma_appliedToDisplayedImage()
+    {
+        label_img widget;
+        widget.resize(64, 48);
+        widget.init();
+
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString imgPath = tmpDir.path() + "/test.png";
+        QImage img(64, 48, QImage::Format_RGB888);
+        img.fill(QColor(128, 128, 128));
+        QVERIFY(img.save(imgPath));
+
+        bool ret = false;
+        widget.openImage(imgPath, ret);
+        QVERIFY(ret);
+
+        widget.setContrastGamma(1.0f);
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 1);
+        QImage identity = widget.pixmap().toImage();
+        widget.setContrastGamma(2.0f);
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 2);
+        QImage darker = widget.pixmap().toImage();
+
+        // Sample a corner far from the cross line drawn at the cursor
+        QPoint corner(identity.width() - 1, identity.height() - 1);
+        QVERIFY(qRed(darker.pixel(corner)) < qRed(identity.pixel(corner)));
+    }
+    void gamma_returningToValueMatchesDirect()
+    {
+        label_img widget;
+        widget.resize(64, 48);
+        widget.init();
+
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString imgPath = tmpDir.path() + "/test.png";
+        QImage img(64, 48, QImage::Format_RGB888);
+        for(int y = 0; y < img.height(); ++y)
+            for(int x = 0; x < img.width(); ++x)
+                img.setPixelColor(x, y, QColor(x * 4, y * 5, 100));
+        QVERIFY(img.save(imgPath));
+
+        bool ret = false;
+        widget.openImage(imgPath, ret);
+        QVERIFY(ret);
+
+        widget.setContrastGamma(0.5f);
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 1);
+        QImage direct = widget.pixmap().toImage();
+
+        // Slider drag: intermediate values, then back to the first one
+        widget.setContrastGamma(2.0f);
+        widget.setContrastGamma(0.5f);
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 2);
+
+        QCOMPARE(widget.pixmap().toImage(), direct);
+    }
 
     // ── cvtRelativeToAbsoluteRectInUi ────────────────────────────
     void absRect_basicAtZoom1()
@@ -803,6 +861,91 @@ private slots:
         QCOMPARE(p, QPoint(320, 240));
     }
 
+    void zoomIn_refinesAfterIdle()
+    {
+        label_img widget;
+        widget.resize(640, 480);
+        widget.init();
+
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString imgPath = tmpDir.path() + "/test.png";
+        QImage img(100, 100, QImage::Format_RGB888);
+        for(int y = 0; y < img.height(); ++y)
+            for(int x = 0; x < img.width(); ++x)
+                img.setPixelColor(x, y, QColor((x * 37) % 256, (y * 53) % 256, 0));
+        QVERIFY(img.save(imgPath));
+
+        bool ret = false;
+        widget.openImage(imgPath, ret);
+        QVERIFY(ret);
+
+        // Wheel-zoom frames use fast scaling; the idle timer redraws smoothly
+        widget.zoomIn(QPoint(320, 240));
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 1);
+        QImage coarse = widget.pixmap().toImage();
+        QTRY_VERIFY_WITH_TIMEOUT(widget.pixmap().toImage() != coarse, 2000);
+    }
+    void zoomIn_burstCoalescesIntoOneFrame()
+    {
+        label_img widget;
+        widget.resize(640, 480);
+        widget.init();
+
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString imgPath = tmpDir.path() + "/test.png";
+        QImage img(100, 100, QImage::Format_RGB888);
+        img.fill(Qt::blue);
+        QVERIFY(img.save(imgPath));
+
+        bool ret = false;
+        widget.openImage(imgPath, ret);
+        QVERIFY(ret);
+
+        // Wheel steps and box nudges delivered together share one repaint
+        for(int i = 0; i < 10; ++i)
+            widget.zoomIn(QPoint(320, 240));
+        widget.setContrastGamma(2.0f);
+        QCOMPARE(widget.frameLatencyStats().frames, 0);
+
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 1);
+        QCOMPARE(widget.frameLatencyStats().coalescedEvents, 11);
+    }
+
+    // ── requestRepaint / frame pacing ────────────────────────────
+    void mouseMove_coalescesIntoOneFrame()
+    {
+        label_img widget;
+        widget.resize(640, 480);
+        widget.init();
+
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString imgPath = tmpDir.path() + "/test.png";
+        QImage img(100, 100, QImage::Format_RGB888);
+        img.fill(Qt::blue);
+        QVERIFY(img.save(imgPath));
+
+        bool ret = false;
+        widget.openImage(imgPath, ret);
+        QVERIFY(ret);
+
+        // A burst delivered before the event loop runs collapses into one repaint
+        for(int i = 0; i < 50; ++i)
+        {
+            QPointF pos(10 + i, 20 + i);
+            QMouseEvent ev(QEvent::MouseMove, pos, widget.mapToGlobal(pos),
+                           Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+            widget.mouseMoveEvent(&ev);
+        }
+        QCOMPARE(widget.frameLatencyStats().frames, 0);
+
+        QTRY_COMPARE(widget.frameLatencyStats().frames, 1);
+        QCOMPARE(widget.frameLatencyStats().coalescedEvents, 50);
+        QVERIFY(widget.frameLatencyStats().lastMs >= 0.0);
+    }
+
     // ── Edge cases for existing functions ─────────────────────────
     void moveBox_zeroMovement()
     {
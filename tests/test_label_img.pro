@@ -1,6 +1,6 @@
 QT += core gui widgets testlib
 CONFIG += c++17 console testcase
 CONFIG -= app_bundle
-SOURCES += test_label_img.cpp ../label_img.cpp
-HEADERS += ../label_img.h
+SOURCES += test_label_img.cpp ../label_img.cpp ../image_cache.cpp
+HEADERS += ../label_img.h ../image_cache.h
 INCLUDEPATH += ..
@@ -0,0 +1,192 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "label_snapshot_store.h"
+
+class TestLabelSnapshotStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void snapshot_restoresPreviousContents()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString label = dir.filePath("a.txt");
+        writeFile(label, "0 0.5 0.5 0.1 0.1\n");
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(label, "1 0.2 0.2 0.1 0.1\n");
+        writeFile(label, "1 0.2 0.2 0.1 0.1\n");
+        const QString pack = store.currentPackPath();
+        store.endRun();
+
+        QCOMPARE(LabelSnapshotStore::restore(pack), 1);
+        QCOMPARE(readFile(label), QByteArray("0 0.5 0.5 0.1 0.1\n"));
+    }
+    void snapshot_createdLabelRemovedOnRestore()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString label = dir.filePath("new.txt");
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(label, "0 0.5 0.5 0.1 0.1\n");
+        writeFile(label, "0 0.5 0.5 0.1 0.1\n");
+        const QString pack = store.currentPackPath();
+        store.endRun();
+
+        QCOMPARE(LabelSnapshotStore::restore(pack), 1);
+        QVERIFY(!QFile::exists(label));
+    }
+    void snapshot_unchangedLabelSkipped()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString label = dir.filePath("a.txt");
+        writeFile(label, "0 0.5 0.5 0.1 0.1\n");
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(label, "0 0.5 0.5 0.1 0.1\n");
+        QCOMPARE(store.snapshotCount(), 0);
+        QVERIFY(store.currentPackPath().isEmpty());   // no pack for a no-op run
+        store.endRun();
+        QVERIFY(store.runs().isEmpty());
+    }
+    void snapshot_crlfLabelCountsAsUnchanged()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString label = dir.filePath("a.txt");
+        writeFile(label, "0 0.5 0.5 0.1 0.1\r\n");
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(label, "0 0.5 0.5 0.1 0.1\n");
+        QCOMPARE(store.snapshotCount(), 0);
+        store.endRun();
+    }
+    void snapshot_restoresExactBytes()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString label = dir.filePath("a.txt");
+        const QByteArray original("0 0.5 0.5 0.1 0.1\r\n\xff\xfe 1 0.2\r\n");  // CRLF, not UTF-8
+        writeFile(label, original);
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(label, "1 0.2 0.2 0.1 0.1\n");
+        writeFile(label, "1 0.2 0.2 0.1 0.1\n");
+        const QString pack = store.currentPackPath();
+        store.endRun();
+
+        QCOMPARE(LabelSnapshotStore::restore(pack), 1);
+        QCOMPARE(readFile(label), original);
+    }
+    void snapshot_keepsOnlyFirstGenerationPerRun()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString label = dir.filePath("a.txt");
+        writeFile(label, "original\n");
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(label, "second\n");
+        writeFile(label, "second\n");
+        store.snapshot(label, "third\n");
+        writeFile(label, "third\n");
+        const QString pack = store.currentPackPath();
+        QCOMPARE(store.snapshotCount(), 1);
+        store.endRun();
+
+        LabelSnapshotStore::restore(pack);
+        QCOMPARE(readFile(label), QByteArray("original\n"));
+    }
+    void snapshot_disabledStoreWritesNothing()
+    {
+        QTemporaryDir dir;
+        const QString label = dir.filePath("a.txt");
+        writeFile(label, "x\n");
+
+        LabelSnapshotStore store{ QString() };
+        store.beginRun();
+        store.snapshot(label, "y\n");
+        QVERIFY(store.currentPackPath().isEmpty());
+        store.endRun();
+    }
+    void runs_listsNewestFirstWithCounts()
+    {
+        QTemporaryDir dir, snapDir;
+        LabelSnapshotStore store(snapDir.path());
+        for (int run = 0; run < 2; ++run) {
+            store.beginRun();
+            for (int k = 0; k <= run; ++k)
+                store.snapshot(dir.filePath(QString("r%1_%2.txt").arg(run).arg(k)), "x\n");
+            store.endRun();
+        }
+
+        const auto runs = store.runs();
+        QCOMPARE(runs.size(), 2);
+        QCOMPARE(runs[0].labels, 2);
+        QCOMPARE(runs[1].labels, 1);
+        QVERIFY(runs[0].created.isValid());
+    }
+    void endRun_prunesOldPacks()
+    {
+        QTemporaryDir dir, snapDir;
+        LabelSnapshotStore store(snapDir.path());
+        for (int run = 0; run < LabelSnapshotStore::MAX_RUNS + 3; ++run) {
+            store.beginRun();
+            store.snapshot(dir.filePath(QString("r%1.txt").arg(run)), "x\n");
+            store.endRun();
+        }
+        QCOMPARE(store.runs().size(), LabelSnapshotStore::MAX_RUNS);
+    }
+    void restore_ignoresTornLastRecord()
+    {
+        QTemporaryDir dir, snapDir;
+        const QString a = dir.filePath("a.txt");
+        const QString b = dir.filePath("b.txt");
+        writeFile(a, "a\n");
+        writeFile(b, "b\n");
+
+        LabelSnapshotStore store(snapDir.path());
+        store.beginRun();
+        store.snapshot(a, "A\n");
+        store.snapshot(b, "B\n");
+        const QString pack = store.currentPackPath();
+        store.endRun();
+        writeFile(a, "A\n");
+        writeFile(b, "B\n");
+
+        // Simulate a crash part-way through the last record
+        QByteArray bytes = readFile(pack);
+        bytes.chop(5);
+        writeFile(pack, bytes);
+
+        QCOMPARE(LabelSnapshotStore::restore(pack), 1);
+        QCOMPARE(readFile(a), QByteArray("a\n"));
+        QCOMPARE(readFile(b), QByteArray("B\n"));
+    }
+    void restore_missingPackFails()
+    {
+        QTemporaryDir dir;
+        QString error;
+        QCOMPARE(LabelSnapshotStore::restore(dir.filePath("none.pack"), &error), -1);
+        QVERIFY(!error.isEmpty());
+    }
+
+private:
+    static void writeFile(const QString &path, const QByteArray &bytes)
+    {
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        f.write(bytes);
+    }
+    static QByteArray readFile(const QString &path)
+    {
+        QFile f(path);
+        return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLabelSnapshotStore)
+#include "test_label_snapshot_store.moc"
@@ -0,0 +1,7 @@
+QT += core testlib
+QT -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+SOURCES += test_label_snapshot_store.cpp ../label_snapshot_store.cpp
+HEADERS += ../label_snapshot_store.h
+INCLUDEPATH += ..
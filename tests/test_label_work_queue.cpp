@@ -0,0 +1,140 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "label_work_queue.h"
+
+class TestLabelWorkQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void claimNext_blocksCoverEveryImageOnce()
+    {
+        QTemporaryDir dir;
+        const QStringList images = imageList(dir.path(), 10);
+        LabelWorkQueue queue(dir.path(), images, 4);
+        QCOMPARE(queue.blockCount(), 3);
+
+        QStringList claimed;
+        for (;;) {
+            const LabelWorkQueue::Block b = queue.claimNext();
+            if (!b.isValid()) break;
+            claimed += b.images;
+        }
+        std::sort(claimed.begin(), claimed.end());
+        QCOMPARE(claimed, images);
+    }
+    void claimNext_workersNeverShareABlock()
+    {
+        QTemporaryDir dir;
+        const QStringList images = imageList(dir.path(), 20);
+        LabelWorkQueue a(dir.path(), images, 3), b(dir.path(), images, 3);
+        a.setWorkerId("a");
+        b.setWorkerId("b");
+
+        QSet<int> seen;
+        bool more = true;
+        while (more) {
+            more = false;
+            for (LabelWorkQueue *q : { &a, &b }) {
+                const LabelWorkQueue::Block block = q->claimNext();
+                if (!block.isValid()) continue;
+                QVERIFY(!seen.contains(block.index));
+                seen.insert(block.index);
+                more = true;
+            }
+        }
+        QCOMPARE(seen.size(), a.blockCount());
+    }
+    void markDone_blockIsNotReissued()
+    {
+        QTemporaryDir dir;
+        const QStringList images = imageList(dir.path(), 4);
+        LabelWorkQueue a(dir.path(), images, 2);
+        a.setWorkerId("a");
+        const LabelWorkQueue::Block first = a.claimNext();
+        QVERIFY(a.markDone(first));
+        QCOMPARE(a.doneCount(), 1);
+        QVERIFY(!QFile::exists(a.directory() + "/" + first.name + ".claim"));
+
+        LabelWorkQueue b(dir.path(), images, 2);
+        b.setWorkerId("b");
+        const LabelWorkQueue::Block second = b.claimNext();
+        QVERIFY(second.isValid());
+        QVERIFY(second.index != first.index);
+        QVERIFY(!b.claimNext().isValid());
+    }
+    void release_blockCanBeClaimedAgain()
+    {
+        QTemporaryDir dir;
+        const QStringList images = imageList(dir.path(), 2);
+        LabelWorkQueue a(dir.path(), images, 2), b(dir.path(), images, 2);
+        a.setWorkerId("a");
+        b.setWorkerId("b");
+        const LabelWorkQueue::Block block = a.claimNext();
+        QVERIFY(!b.claimNext().isValid());
+        a.release(block);
+        QCOMPARE(b.claimNext().index, block.index);
+    }
+    void claimNext_liveClaimIsRespected()
+    {
+        QTemporaryDir dir;
+        const QStringList images = imageList(dir.path(), 2);
+        LabelWorkQueue a(dir.path(), images, 2), b(dir.path(), images, 2);
+        a.setWorkerId("a");
+        b.setWorkerId("b");
+        b.setLeaseMs(60 * 1000);
+        const LabelWorkQueue::Block block = a.claimNext();
+        QVERIFY(block.isValid());
+        QVERIFY(!b.claimNext().isValid());
+        QVERIFY(a.renew(block));
+    }
+    void claimNext_expiredClaimIsTakenOver()
+    {
+        QTemporaryDir dir;
+        const QStringList images = imageList(dir.path(), 2);
+        LabelWorkQueue a(dir.path(), images, 2), b(dir.path(), images, 2);
+        a.setWorkerId("a");
+        b.setWorkerId("b");
+        b.setLeaseMs(60 * 1000);
+        const LabelWorkQueue::Block block = a.claimNext();
+
+        // Worker a crashed ten minutes ago
+        QFile claim(a.directory() + "/" + block.name + ".claim");
+        QVERIFY(claim.open(QIODevice::ReadWrite));
+        QVERIFY(claim.setFileTime(QDateTime::currentDateTimeUtc().addSecs(-600),
+                                  QFileDevice::FileModificationTime));
+        claim.close();
+
+        QCOMPARE(b.claimNext().index, block.index);
+        QVERIFY(!a.renew(block));
+        QCOMPARE(QDir(a.directory()).entryList(QDir::Files).size(), 1);
+    }
+    void blockNames_ignoreDatasetLocation()
+    {
+        QTemporaryDir dir1, dir2;
+        LabelWorkQueue a(dir1.path(), imageList(dir1.path(), 3), 3);
+        LabelWorkQueue b(dir2.path(), imageList(dir2.path(), 3), 3);
+        QCOMPARE(a.claimNext().name, b.claimNext().name);
+    }
+    void blockNames_changeWithDataset()
+    {
+        QTemporaryDir dir1, dir2;
+        QStringList other = imageList(dir2.path(), 3);
+        other[1] = dir2.filePath("renamed.jpg");
+        LabelWorkQueue a(dir1.path(), imageList(dir1.path(), 3), 3);
+        LabelWorkQueue b(dir2.path(), other, 3);
+        QVERIFY(a.claimNext().name != b.claimNext().name);
+    }
+
+private:
+    static QStringList imageList(const QString &dir, int n)
+    {
+        QStringList out;
+        for (int i = 0; i < n; ++i)
+            out.append(QString("%1/img%2.jpg").arg(dir).arg(i, 3, 10, QChar('0')));
+        return out;
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLabelWorkQueue)
+#include "test_label_work_queue.moc"
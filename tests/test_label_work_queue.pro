@@ -0,0 +1,7 @@
+QT += core testlib
+QT -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+SOURCES += test_label_work_queue.cpp ../label_work_queue.cpp
+HEADERS += ../label_work_queue.h
+INCLUDEPATH += ..
@@ -0,0 +1,130 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <atomic>
+#include <thread>
+#include "trace.h"
+
+class FakeReply : public QObject
+{
+    Q_OBJECT
+signals:
+    void finished();
+};
+
+class TestTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init() { Trace::clear(); }
+
+    void scope_recordsCompleteEvent()
+    {
+        {
+            TRACE_SCOPE("test", "outer");
+            TRACE_SCOPE("test", "inner");
+        }
+        const QList<QJsonObject> spans = events("X");
+        QCOMPARE(spans.size(), 2);
+        // Inner scope ends first and lies within the outer one
+        QCOMPARE(spans[0]["name"].toString(), QString("inner"));
+        QCOMPARE(spans[1]["name"].toString(), QString("outer"));
+        QCOMPARE(spans[1]["cat"].toString(), QString("test"));
+        QVERIFY(spans[0]["ts"].toDouble() >= spans[1]["ts"].toDouble());
+        QVERIFY(spans[0]["dur"].toDouble() <= spans[1]["dur"].toDouble());
+    }
+    void scope_threadsGetTheirOwnTid()
+    {
+        { TRACE_SCOPE("test", "main"); }
+        std::thread worker([] { TRACE_SCOPE("test", "worker"); });
+        worker.join();
+
+        const QList<QJsonObject> spans = events("X");
+        QCOMPARE(spans.size(), 2);
+        QVERIFY(spans[0]["tid"].toInt() != spans[1]["tid"].toInt());
+        // Buffers outlive their thread, and threads are named
+        QVERIFY(events("M").size() >= 2);
+    }
+    void ring_keepsNewestEvents()
+    {
+        const int n = Trace::EVENTS_PER_THREAD + 100;
+        for (int i = 0; i < n; ++i)
+            Trace::recordComplete("test", i < 100 ? "old" : "new", i, i + 1);
+
+        const QList<QJsonObject> spans = events("X");
+        QCOMPARE(spans.size(), Trace::EVENTS_PER_THREAD);
+        for (const QJsonObject &e : spans)
+            QCOMPARE(e["name"].toString(), QString("new"));
+    }
+    void snapshot_whileWriterWrapsRing()
+    {
+        // A dump racing a writer that laps the ring must never show a torn
+        // event (and must be clean under -fsanitize=thread)
+        std::atomic<bool> stop{ false };
+        std::thread writer([&stop] {
+            for (int64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+                Trace::recordComplete("test", (i & 1) ? "odd" : "even", 2 * i, 2 * i + (i & 1));
+        });
+        for (int round = 0; round < 5; ++round) {
+            for (const QJsonObject &e : events("X")) {
+                const bool odd = e["name"].toString() == "odd";
+                QCOMPARE(e["dur"].toDouble(), odd ? 0.001 : 0.0);
+                QCOMPARE(qint64(e["ts"].toDouble() * 1000 + 0.5) / 2 % 2, qint64(odd));
+            }
+        }
+        stop = true;
+        writer.join();
+    }
+    void request_recordsAsyncPair()
+    {
+        FakeReply reply;
+        TRACE_REQUEST("cloud", "GET /v1/jobs/{id}", &reply);
+        QVERIFY(events("b").isEmpty());
+        emit reply.finished();
+
+        const QList<QJsonObject> b = events("b"), e = events("e");
+        QCOMPARE(b.size(), 1);
+        QCOMPARE(e.size(), 1);
+        QCOMPARE(b[0]["id"], e[0]["id"]);
+        QCOMPARE(b[0]["name"].toString(), QString("GET /v1/jobs/{id}"));
+        QVERIFY(e[0]["ts"].toDouble() >= b[0]["ts"].toDouble());
+    }
+    void writeJson_producesLoadableFile()
+    {
+        { TRACE_SCOPE("test", "quote\"name"); }
+        QTemporaryDir dir;
+        const QString path = dir.filePath("sub/trace.json");
+        QVERIFY(Trace::writeJson(path));
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        QJsonParseError err;
+        const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &err);
+        QCOMPARE(err.error, QJsonParseError::NoError);
+        QVERIFY(doc.object()["traceEvents"].isArray());
+    }
+    void clear_dropsRecordedEvents()
+    {
+        { TRACE_SCOPE("test", "gone"); }
+        Trace::clear();
+        QVERIFY(events("X").isEmpty());
+    }
+
+private:
+    static QList<QJsonObject> events(const QString &phase)
+    {
+        QJsonParseError err;
+        const QJsonDocument doc = QJsonDocument::fromJson(Trace::toJson(), &err);
+        if (err.error != QJsonParseError::NoError) return {};
+        QList<QJsonObject> out;
+        for (const QJsonValue &v : doc.object()["traceEvents"].toArray())
+            if (v.toObject()["ph"].toString() == phase)
+                out.append(v.toObject());
+        return out;
+    }
+};
+
+QTEST_GUILESS_MAIN(TestTrace)
+#include "test_trace.moc"
@@ -0,0 +1,8 @@
+QT += core testlib
+QT -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+DEFINES += YOLOLABEL_TRACE
+SOURCES += test_trace.cpp ../trace.cpp
+HEADERS += ../trace.h
+INCLUDEPATH += ..
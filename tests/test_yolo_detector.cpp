@@ -1,5 +1,7 @@
 #include <QtTest>
+#include <QTemporaryDir>
 #include "yolo_detector.h"
+#include "onnx_fixture.h"
 
 class TestYoloDetector : public QObject
 {
@@ -96,6 +98,82 @@ private slots:
         QCOMPARE(result.second, 320);
     }
 
+    // ── loadInputImage ───────────────────────────────────────────
+    void loadInputImage_notLoadedDecodesFullSize()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = tmpDir.path() + "/big.jpg";
+        QImage img(2000, 1000, QImage::Format_RGB888);
+        img.fill(Qt::gray);
+        QVERIFY(img.save(path));
+
+        YoloDetector detector;
+        QCOMPARE(detector.loadInputImage(path).size(), QSize(2000, 1000));
+    }
+    void loadInputImage_scaledToLetterboxSize()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = tmpDir.path() + "/big.jpg";
+        QImage img(2000, 1000, QImage::Format_RGB888);
+        img.fill(Qt::gray);
+        QVERIFY(img.save(path));
+
+        YoloDetector detector;
+        detector.m_inputWidth  = 640;
+        detector.m_inputHeight = 640;
+        detector.m_loaded      = true;
+
+        // Letterbox scale = min(640/2000, 640/1000) = 0.32
+        QCOMPARE(detector.loadInputImage(path).size(), QSize(640, 320));
+    }
+    void loadInputImage_matchesPreprocessSize_data()
+    {
+        QTest::addColumn<QSize>("imageSize");
+        // Sizes whose float scale lands just above an integer
+        QTest::newRow("3000x1999") << QSize(3000, 1999);
+        QTest::newRow("1999x3001") << QSize(1999, 3001);
+        QTest::newRow("4031x3023") << QSize(4031, 3023);
+        QTest::newRow("2047x2047") << QSize(2047, 2047);
+    }
+    void loadInputImage_matchesPreprocessSize()
+    {
+        QFETCH(QSize, imageSize);
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = tmpDir.path() + "/odd.png";
+        QImage img(imageSize, QImage::Format_RGB888);
+        img.fill(Qt::gray);
+        QVERIFY(img.save(path));
+
+        YoloDetector detector;
+        detector.m_inputWidth  = 640;
+        detector.m_inputHeight = 640;
+        detector.m_loaded      = true;
+
+        const QImage decoded = detector.loadInputImage(path);
+        QCOMPARE(decoded.size(), detector.letterboxSize(imageSize.width(), imageSize.height()));
+        // preprocess() then keeps the decoded size as is
+        QCOMPARE(detector.letterboxSize(decoded.width(), decoded.height()), decoded.size());
+    }
+    void loadInputImage_smallImageUntouched()
+    {
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QString path = tmpDir.path() + "/small.png";
+        QImage img(320, 240, QImage::Format_RGB888);
+        img.fill(Qt::gray);
+        QVERIFY(img.save(path));
+
+        YoloDetector detector;
+        detector.m_inputWidth  = 640;
+        detector.m_inputHeight = 640;
+        detector.m_loaded      = true;
+
+        QCOMPARE(detector.loadInputImage(path).size(), QSize(320, 240));
+    }
+
     // ── iou ──────────────────────────────────────────────────────
     void iou_perfectOverlap()
     {
@@ -221,6 +299,141 @@ private slots:
         auto keep = YoloDetector::nms(boxes, 0.45f);
         QCOMPARE(keep.size(), size_t(2));
     }
+
+    // ── DetectorStats ────────────────────────────────────────────
+    void stats_emptyUntilRecorded()
+    {
+        YoloDetector detector;
+        QVERIFY(detector.getStats().isEmpty());
+        QCOMPARE(detector.getStats().last().runMs, 0.0);
+        QCOMPARE(detector.getStats().percentile(0.5).runMs, 0.0);
+    }
+    void stats_lastIsMostRecentCall()
+    {
+        DetectorStats stats;
+        for (int i = 1; i <= 3; ++i) {
+            DetectorStageTimes t;
+            t.runMs = i;
+            t.candidates = 10 * i;
+            stats.record(t);
+        }
+        QCOMPARE(stats.calls(), uint64_t(3));
+        QCOMPARE(stats.last().runMs, 3.0);
+        QCOMPARE(stats.last().candidates, 30);
+    }
+    void stats_percentilePerField()
+    {
+        DetectorStats stats;
+        for (int i = 0; i < 101; ++i) {
+            DetectorStageTimes t;
+            t.preprocessMs = i;
+            t.runMs = 100 - i;
+            stats.record(t);
+        }
+        QCOMPARE(stats.percentile(0.5).preprocessMs, 50.0);
+        QCOMPARE(stats.percentile(0.5).runMs, 50.0);
+        QCOMPARE(stats.percentile(0.0).runMs, 0.0);
+        QCOMPARE(stats.percentile(1.0).runMs, 100.0);
+    }
+    void stats_windowDropsOldCalls()
+    {
+        DetectorStats stats;
+        for (int i = 0; i < DetectorStats::WINDOW + 10; ++i) {
+            DetectorStageTimes t;
+            t.nmsMs = i < 10 ? 1000.0 : 1.0;
+            stats.record(t);
+        }
+        QCOMPARE(stats.calls(), uint64_t(DetectorStats::WINDOW + 10));
+        QCOMPARE(stats.percentile(1.0).nmsMs, 1.0);
+        stats.reset();
+        QVERIFY(stats.isEmpty());
+    }
+
+    // ── generated ONNX fixtures ──────────────────────────────────
+    void fixture_loadDetectsFormat_data()
+    {
+        QTest::addColumn<int>("kind");
+        QTest::addColumn<int>("classes");
+        QTest::addColumn<int>("inputSize");
+        QTest::addColumn<int>("version");
+        QTest::addColumn<bool>("endToEnd");
+        QTest::newRow("v5, 80 classes")  << int(OnnxFixtureKind::V5)       << 80 << 640 << int(YoloVersion::V5)  << false;
+        QTest::newRow("v5, 1 class")     << int(OnnxFixtureKind::V5)       << 1  << 640 << int(YoloVersion::V5)  << false;
+        QTest::newRow("v8, 80 classes")  << int(OnnxFixtureKind::V8)       << 80 << 640 << int(YoloVersion::V8)  << false;
+        QTest::newRow("v8, 1 class")     << int(OnnxFixtureKind::V8)       << 1  << 640 << int(YoloVersion::V8)  << false;
+        QTest::newRow("v8, 320 input")   << int(OnnxFixtureKind::V8)       << 80 << 320 << int(YoloVersion::V8)  << false;
+        QTest::newRow("e2e, 80 classes") << int(OnnxFixtureKind::EndToEnd) << 80 << 640 << int(YoloVersion::V26) << true;
+    }
+    void fixture_loadDetectsFormat()
+    {
+        QFETCH(int, kind);
+        QFETCH(int, classes);
+        QFETCH(int, inputSize);
+        QFETCH(int, version);
+        QFETCH(bool, endToEnd);
+
+        OnnxFixtureSpec spec;
+        spec.kind       = OnnxFixtureKind(kind);
+        spec.numClasses = classes;
+        spec.inputSize  = inputSize;
+
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        YoloDetector detector;
+        std::string error;
+        QVERIFY2(loadFixture(detector, tmpDir, spec, error), error.c_str());
+        QCOMPARE(int(detector.getVersion()), version);
+        QCOMPARE(detector.isEndToEnd(), endToEnd);
+        QCOMPARE(detector.getNumClasses(), classes);
+        QCOMPARE(detector.getInputWidth(), inputSize);
+        QCOMPARE(detector.getClassNames().at(0), std::string("class0"));
+    }
+    void fixture_decodersAgree()
+    {
+        // All kinds plant the same objects for the same seed; the end-to-end
+        // head reports them exactly, the others through scores and NMS.
+        QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        QImage image(640, 640, QImage::Format_RGB888);
+        image.fill(QColor(128, 128, 128));
+
+        OnnxFixtureSpec spec;
+        spec.kind = OnnxFixtureKind::EndToEnd;
+        YoloDetector e2e;
+        std::string error;
+        QVERIFY2(loadFixture(e2e, tmpDir, spec, error), error.c_str());
+        const std::vector<DetectionResult> planted = e2e.detect(image, 0.25f, 0.45f);
+        QCOMPARE(int(planted.size()), spec.objects);
+
+        for (OnnxFixtureKind kind : { OnnxFixtureKind::V5, OnnxFixtureKind::V8 }) {
+            spec.kind = kind;
+            YoloDetector detector;
+            QVERIFY2(loadFixture(detector, tmpDir, spec, error), error.c_str());
+            const std::vector<DetectionResult> found = detector.detect(image, 0.25f, 0.45f);
+            QVERIFY(detector.getStats().last().candidates > int(found.size()));
+            // Boxes are jittered by a few pixels, which costs small boxes some IoU
+            for (const DetectionResult& d : found)
+                QVERIFY2(matches(d, planted), onnxFixtureKindName(kind));
+            for (const DetectionResult& p : planted)
+                QVERIFY2(matches(p, found), onnxFixtureKindName(kind));
+        }
+    }
+
+private:
+    static bool loadFixture(YoloDetector& detector, const QTemporaryDir& dir,
+                            const OnnxFixtureSpec& spec, std::string& error)
+    {
+        const std::string path = dir.filePath(QString("%1.onnx").arg(onnxFixtureKindName(spec.kind))).toStdString();
+        return writeOnnxFixture(path, spec, error) && detector.loadModel(path, error, 1);
+    }
+
+    static bool matches(const DetectionResult& d, const std::vector<DetectionResult>& others)
+    {
+        for (const DetectionResult& o : others)
+            if (o.classId == d.classId && YoloDetector::iou(o, d) > 0.6f)
+                return true;
+        return false;
+    }
 };
 
 QTEST_GUILESS_MAIN(TestYoloDetector)
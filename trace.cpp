@@ -0,0 +1,257 @@
+#include "trace.h"
+
+#ifdef YOLOLABEL_TRACE
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+namespace {
+
+struct Event
+{
+    const char *cat;
+    const char *name;
+    int64_t     startNs;
+    int64_t     endNs;
+    bool        async;
+};
+
+// One ring buffer entry. The fields are atomics so a reader copying a slot
+// the writer is overwriting is not a data race; the copy is simply discarded
+// (see ThreadBuffer::snapshot()). Release stores and acquire loads compile
+// to plain moves on x86.
+struct Slot
+{
+    std::atomic<const char *> cat{ nullptr };
+    std::atomic<const char *> name{ nullptr };
+    std::atomic<int64_t>      startNs{ 0 };
+    std::atomic<int64_t>      endNs{ 0 };
+    std::atomic<bool>         async{ false };
+};
+
+// Single writer (the owning thread), any number of readers, as in a seqlock:
+// the writer bumps `started` before touching a slot and `written` after, and
+// a reader copies the live range and then drops every slot whose overwrite
+// had started by the time the copy finished. A field value from an
+// overwrite is a release store sequenced after its `started` bump, so a
+// reader that loads it (acquire) then sees that bump. No standalone fences,
+// which ThreadSanitizer does not model.
+struct ThreadBuffer
+{
+    int                                      tid = 0;
+    QString                                  name;
+    std::array<Slot, EVENTS_PER_THREAD>      slots;
+    std::atomic<uint64_t>                    started{ 0 };   // appends begun
+    std::atomic<uint64_t>                    written{ 0 };   // appends completed
+    std::atomic<uint64_t>                    cleared{ 0 };   // events before this are gone
+
+    void append(const Event &e)
+    {
+        const uint64_t w = written.load(std::memory_order_relaxed);
+        started.store(w + 1, std::memory_order_relaxed);
+
+        Slot &s = slots[w % EVENTS_PER_THREAD];
+        s.cat.store(e.cat, std::memory_order_release);
+        s.name.store(e.name, std::memory_order_release);
+        s.startNs.store(e.startNs, std::memory_order_release);
+        s.endNs.store(e.endNs, std::memory_order_release);
+        s.async.store(e.async, std::memory_order_release);
+        written.store(w + 1, std::memory_order_release);
+    }
+
+    std::vector<Event> snapshot() const
+    {
+        const uint64_t end   = written.load(std::memory_order_acquire);
+        uint64_t       begin = std::max(cleared.load(std::memory_order_acquire),
+                                        end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0);
+        std::vector<Event> out;
+        out.reserve(end - begin);
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot &s = slots[i % EVENTS_PER_THREAD];
+            out.push_back(Event{ s.cat.load(std::memory_order_acquire),
+                                 s.name.load(std::memory_order_acquire),
+                                 s.startNs.load(std::memory_order_acquire),
+                                 s.endNs.load(std::memory_order_acquire),
+                                 s.async.load(std::memory_order_acquire) });
+        }
+
+        // Slot i was reused by append number i + EVENTS_PER_THREAD
+        const uint64_t after = started.load(std::memory_order_relaxed);
+        const uint64_t lost  = after > EVENTS_PER_THREAD ? after - EVENTS_PER_THREAD : 0;
+        if (lost > begin)
+            out.erase(out.begin(), out.begin() + std::ptrdiff_t(std::min<uint64_t>(lost - begin, out.size())));
+        return out;
+    }
+};
+
+struct Registry
+{
+    std::mutex                                 mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;   // outlive their threads
+    std::atomic<uint64_t>                      asyncIds{ 0 };
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+Registry &registry()
+{
+    static Registry r;
+    return r;
+}
+
+ThreadBuffer &threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto b = std::make_shared<ThreadBuffer>();
+        QThread *thread = QThread::currentThread();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            b->name = "main";
+        else if (thread && !thread->objectName().isEmpty())
+            b->name = thread->objectName();
+
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        b->tid = int(r.buffers.size()) + 1;
+        if (b->name.isEmpty())
+            b->name = QString("thread %1").arg(b->tid);
+        r.buffers.push_back(b);
+        return b;
+    }();
+    return *buffer;
+}
+
+void appendEscaped(QByteArray &out, const char *s)
+{
+    for (; *s; ++s) {
+        const char c = *s;
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+}
+
+void appendMicros(QByteArray &out, int64_t ns)
+{
+    out += QByteArray::number(double(ns) / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void recordComplete(const char *cat, const char *name, int64_t startNs, int64_t endNs)
+{
+    threadBuffer().append(Event{ cat, name, startNs, endNs, false });
+}
+
+void recordAsync(const char *cat, const char *name, int64_t startNs, int64_t endNs)
+{
+    threadBuffer().append(Event{ cat, name, startNs, endNs, true });
+}
+
+void clear()
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto &b : r.buffers)
+        b->cleared.store(b->written.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+QByteArray toJson()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffers = r.buffers;
+    }
+    const qint64 pid = QCoreApplication::applicationPid();
+    const QByteArray pidStr = QByteArray::number(pid);
+
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto begin = [&]() {
+        if (!first) out += ",\n";
+        first = false;
+    };
+
+    for (const auto &b : buffers) {
+        const QByteArray tid = QByteArray::number(b->tid);
+        begin();
+        out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pidStr + ",\"tid\":" + tid
+             + ",\"args\":{\"name\":\"";
+        appendEscaped(out, b->name.toUtf8().constData());
+        out += "\"}}";
+
+        for (const Event &e : b->snapshot()) {
+            if (!e.async) {
+                begin();
+                out += "{\"ph\":\"X\",\"cat\":\"";
+                appendEscaped(out, e.cat);
+                out += "\",\"name\":\"";
+                appendEscaped(out, e.name);
+                out += "\",\"pid\":" + pidStr + ",\"tid\":" + tid + ",\"ts\":";
+                appendMicros(out, e.startNs);
+                out += ",\"dur\":";
+                appendMicros(out, e.endNs - e.startNs);
+                out += '}';
+                continue;
+            }
+            // Async spans are a begin/end pair sharing an id
+            const QByteArray id = QByteArray::number(++registry().asyncIds);
+            for (const char *ph : { "b", "e" }) {
+                begin();
+                out += "{\"ph\":\"" + QByteArray(ph) + "\",\"cat\":\"";
+                appendEscaped(out, e.cat);
+                out += "\",\"name\":\"";
+                appendEscaped(out, e.name);
+                out += "\",\"id\":" + id + ",\"pid\":" + pidStr + ",\"tid\":" + tid + ",\"ts\":";
+                appendMicros(out, *ph == 'b' ? e.startNs : e.endNs);
+                out += '}';
+            }
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool writeJson(const QString &path, QString *error)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile f(path);
+    if (f.open(QIODevice::WriteOnly) && f.write(toJson()) >= 0 && f.commit())
+        return true;
+    if (error) *error = f.errorString();
+    return false;
+}
+
+QString defaultPath()
+{
+    const QString env = qEnvironmentVariable("YOLOLABEL_TRACE_FILE");
+    if (!env.isEmpty()) return env;
+    QString base = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (base.isEmpty()) base = QDir::tempPath();
+    return base + "/traces/trace-"
+         + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json";
+}
+
+} // namespace Trace
+
+#endif // YOLOLABEL_TRACE
@@ -0,0 +1,85 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Chrome/Perfetto trace events for the labeling pipeline. Build with
+//
+//   qmake CONFIG+=trace
+//
+// to define YOLOLABEL_TRACE; otherwise every TRACE_* macro expands to
+// nothing and costs nothing. When enabled, each thread appends fixed-size
+// events to its own ring buffer (no locks, no allocation after the first
+// event), and Trace::writeJson() dumps all buffers as trace_event JSON that
+// chrome://tracing and ui.perfetto.dev open directly. Names and categories
+// must be string literals; only the pointers are stored.
+//
+//   TRACE_SCOPE("label_img", "showImage");        // span until end of scope
+//   TRACE_REQUEST("cloud", "GET /v1/jobs/{id}", reply);  // until finished()
+
+#ifdef YOLOLABEL_TRACE
+
+#include <QObject>
+#include <QString>
+#include <cstdint>
+
+namespace Trace {
+
+// Events kept per thread; older events are overwritten.
+constexpr int EVENTS_PER_THREAD = 1 << 16;
+
+int64_t nowNs();
+void    recordComplete(const char *cat, const char *name, int64_t startNs, int64_t endNs);
+// A span not bound to one scope (e.g. a network request); may overlap
+// other spans on the same thread.
+void    recordAsync(const char *cat, const char *name, int64_t startNs, int64_t endNs);
+
+// Writes every thread's buffered events. Safe to call while other threads
+// keep tracing; events overwritten during the copy are dropped.
+bool    writeJson(const QString &path, QString *error = nullptr);
+QByteArray toJson();
+// $YOLOLABEL_TRACE_FILE if set, else a timestamped file under the app's
+// local data directory.
+QString defaultPath();
+// Drops all recorded events (threads keep their buffers).
+void    clear();
+
+class Scope
+{
+public:
+    Scope(const char *cat, const char *name) : m_cat(cat), m_name(name), m_start(nowNs()) {}
+    ~Scope() { recordComplete(m_cat, m_name, m_start, nowNs()); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_cat;
+    const char *m_name;
+    int64_t     m_start;
+};
+
+// Records an async span from now until reply emits finished().
+template <class Reply>
+void traceReply(const char *cat, const char *name, Reply *reply)
+{
+    const int64_t start = nowNs();
+    QObject::connect(reply, &Reply::finished, reply, [cat, name, start]() {
+        recordAsync(cat, name, start, nowNs());
+    });
+}
+
+} // namespace Trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(cat, name) \
+    const Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(cat, name)
+#define TRACE_REQUEST(cat, name, reply) Trace::traceReply(cat, name, reply)
+
+#else
+
+#define TRACE_SCOPE(cat, name)
+#define TRACE_REQUEST(cat, name, reply)
+
+#endif // YOLOLABEL_TRACE
+
+#endif // TRACE_H
@@ -1,11 +1,57 @@
 #include "yolo_detector.h"
+#include "trace.h"
+#include <QImageReader>
 #include <algorithm>
+#include <chrono>
 #include <numeric>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <thread>
 
+void DetectorStats::record(const DetectorStageTimes& t)
+{
+    m_ring[m_next] = t;
+    m_next = (m_next + 1) % WINDOW;
+    m_size = std::min(m_size + 1, WINDOW);
+    ++m_calls;
+}
+
+void DetectorStats::reset()
+{
+    m_size = 0;
+    m_next = 0;
+    m_calls = 0;
+}
+
+const DetectorStageTimes& DetectorStats::last() const
+{
+    static const DetectorStageTimes none;
+    return m_size == 0 ? none : m_ring[(m_next + WINDOW - 1) % WINDOW];
+}
+
+DetectorStageTimes DetectorStats::percentile(double p) const
+{
+    DetectorStageTimes out;
+    if (m_size == 0) return out;
+
+    const int rank = std::clamp(static_cast<int>(p * (m_size - 1) + 0.5), 0, m_size - 1);
+    auto pick = [&](auto field) {
+        std::array<double, WINDOW> values;
+        for (int i = 0; i < m_size; ++i)
+            values[i] = static_cast<double>(m_ring[i].*field);
+        std::nth_element(values.begin(), values.begin() + rank, values.begin() + m_size);
+        return values[rank];
+    };
+    out.preprocessMs  = pick(&DetectorStageTimes::preprocessMs);
+    out.runMs         = pick(&DetectorStageTimes::runMs);
+    out.postprocessMs = pick(&DetectorStageTimes::postprocessMs);
+    out.nmsMs         = pick(&DetectorStageTimes::nmsMs);
+    out.candidates    = static_cast<int>(pick(&DetectorStageTimes::candidates));
+    out.kept          = static_cast<int>(pick(&DetectorStageTimes::kept));
+    return out;
+}
+
 YoloDetector::YoloDetector()
     : m_env(ORT_LOGGING_LEVEL_WARNING, "YoloLabel")
     , m_inputWidth(0)
@@ -18,12 +64,15 @@ YoloDetector::YoloDetector()
 
 YoloDetector::~YoloDetector() = default;
 
-bool YoloDetector::loadModel(const std::string& modelPath, std::string& errorMsg)
+bool YoloDetector::loadModel(const std::string& modelPath, std::string& errorMsg,
+                             int intraOpThreads)
 {
+    TRACE_SCOPE("YoloDetector", "loadModel");
     try {
         Ort::SessionOptions sessionOptions;
-        sessionOptions.SetIntraOpNumThreads(
-            static_cast<int>(std::thread::hardware_concurrency()));
+        sessionOptions.SetIntraOpNumThreads(intraOpThreads > 0
+            ? intraOpThreads
+            : static_cast<int>(std::thread::hardware_concurrency()));
         sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
 
 #ifdef _WIN32
@@ -97,6 +146,7 @@ bool YoloDetector::loadModel(const std::string& modelPath, std::string& errorMsg
         }
 
         m_loaded = true;
+        m_stats.reset();
         return true;
 
     } catch (const Ort::Exception& e) {
@@ -265,21 +315,34 @@ std::pair<int, int> YoloDetector::parseImgsz(const std::string& str)
     return {640, 640};
 }
 
+float YoloDetector::letterboxScale(int imgW, int imgH) const
+{
+    return std::min(
+        static_cast<float>(m_inputWidth) / imgW,
+        static_cast<float>(m_inputHeight) / imgH);
+}
+
+QSize YoloDetector::letterboxSize(int imgW, int imgH) const
+{
+    float scale = letterboxScale(imgW, imgH);
+    return QSize(static_cast<int>(std::round(imgW * scale)),
+                 static_cast<int>(std::round(imgH * scale)));
+}
+
 std::vector<float> YoloDetector::preprocess(
     const QImage& image,
     float& scaleX, float& scaleY,
     float& padX, float& padY)
 {
+    TRACE_SCOPE("YoloDetector", "preprocess");
     int imgW = image.width();
     int imgH = image.height();
 
     // Letterbox: scale to fit while maintaining aspect ratio
-    float scale = std::min(
-        static_cast<float>(m_inputWidth) / imgW,
-        static_cast<float>(m_inputHeight) / imgH);
-
-    int newW = static_cast<int>(std::round(imgW * scale));
-    int newH = static_cast<int>(std::round(imgH * scale));
+    float scale = letterboxScale(imgW, imgH);
+    QSize newSize = letterboxSize(imgW, imgH);
+    int newW = newSize.width();
+    int newH = newSize.height();
 
     padX = (m_inputWidth - newW) / 2.0f;
     padY = (m_inputHeight - newH) / 2.0f;
@@ -314,13 +377,50 @@ std::vector<float> YoloDetector::preprocess(
     return blob;
 }
 
+QImage YoloDetector::loadInputImage(const QString& path) const
+{
+    TRACE_SCOPE("YoloDetector", "loadInputImage");
+    QImageReader reader(path);
+    reader.setAllocationLimit(0);
+    reader.setAutoTransform(true);
+
+    QSize stored = reader.size();
+    if (m_loaded && stored.isValid() && m_inputWidth > 0 && m_inputHeight > 0) {
+        // The letterbox scale is defined on the displayed (EXIF-rotated) size,
+        // while setScaledSize() applies before the rotation.
+        QSize shown = stored;
+        if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+            shown.transpose();
+
+        // Only worth it when the decoder can skip most of the pixels.
+        // Decoding straight to preprocess()'s letterbox size makes its own
+        // scale exactly 1 on the fitted axis, so it does not resample again.
+        if (letterboxScale(shown.width(), shown.height()) < 0.75f) {
+            QSize target = letterboxSize(shown.width(), shown.height());
+            if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+                target.transpose();
+            reader.setScaledSize(QSize(std::max(1, target.width()), std::max(1, target.height())));
+        }
+    }
+
+    return reader.read();
+}
+
 std::vector<DetectionResult> YoloDetector::detect(
     const QImage& image,
     float confThreshold,
     float nmsIouThreshold)
 {
+    TRACE_SCOPE("YoloDetector", "detect");
     if (!m_loaded || image.isNull()) return {};
 
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    };
+    DetectorStageTimes times;
+    Clock::time_point stageStart = Clock::now();
+
     int imgW = image.width();
     int imgH = image.height();
 
@@ -339,9 +439,13 @@ std::vector<DetectionResult> YoloDetector::detect(
     for (const auto& s : m_inputNameStrings) inputNames.push_back(s.c_str());
     for (const auto& s : m_outputNameStrings) outputNames.push_back(s.c_str());
 
+    times.preprocessMs = msSince(stageStart);
+    stageStart = Clock::now();
+
     // Run inference
     std::vector<Ort::Value> outputs;
     try {
+        TRACE_SCOPE("YoloDetector", "Session::Run");
         outputs = m_session->Run(
             Ort::RunOptions{nullptr},
             inputNames.data(), &inputOrtTensor, 1,
@@ -349,6 +453,8 @@ std::vector<DetectionResult> YoloDetector::detect(
     } catch (const Ort::Exception& e) {
         return {};
     }
+    times.runMs = msSince(stageStart);
+    stageStart = Clock::now();
 
     const float* outputData = outputs[0].GetTensorData<float>();
     auto outputShape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
@@ -365,6 +471,9 @@ std::vector<DetectionResult> YoloDetector::detect(
         results = postprocessEndToEnd(outputData,
             static_cast<int>(dim1),
             confThreshold, scaleX, scaleY, padX, padY, imgW, imgH);
+        times.postprocessMs = msSince(stageStart);
+        times.candidates = times.kept = static_cast<int>(results.size());
+        m_stats.record(times);
         return results;
     }
 
@@ -383,6 +492,10 @@ std::vector<DetectionResult> YoloDetector::detect(
             confThreshold, scaleX, scaleY, padX, padY, imgW, imgH);
     }
 
+    times.postprocessMs = msSince(stageStart);
+    times.candidates = static_cast<int>(results.size());
+    stageStart = Clock::now();
+
     // Apply NMS
     auto keepIndices = nms(results, nmsIouThreshold);
     std::vector<DetectionResult> finalResults;
@@ -390,6 +503,9 @@ std::vector<DetectionResult> YoloDetector::detect(
     for (int idx : keepIndices) {
         finalResults.push_back(results[idx]);
     }
+    times.nmsMs = msSince(stageStart);
+    times.kept = static_cast<int>(finalResults.size());
+    m_stats.record(times);
 
     return finalResults;
 }
@@ -403,6 +519,7 @@ std::vector<DetectionResult> YoloDetector::postprocessV5(
     float padX, float padY,
     int imgWidth, int imgHeight)
 {
+    TRACE_SCOPE("YoloDetector", "postprocessV5");
     // V5 output: [B, N, C+5] where each row = [cx, cy, w, h, obj_conf, cls0, cls1, ...]
     std::vector<DetectionResult> results;
     int stride = numClasses + 5;
@@ -464,6 +581,7 @@ std::vector<DetectionResult> YoloDetector::postprocessV8(
     float padX, float padY,
     int imgWidth, int imgHeight)
 {
+    TRACE_SCOPE("YoloDetector", "postprocessV8");
     // V8 output: [B, C+4, N] — transposed layout
     // Row 0: cx, Row 1: cy, Row 2: w, Row 3: h, Rows 4..C+3: class scores
     std::vector<DetectionResult> results;
@@ -518,6 +636,7 @@ std::vector<DetectionResult> YoloDetector::postprocessEndToEnd(
     float padX, float padY,
     int imgWidth, int imgHeight)
 {
+    TRACE_SCOPE("YoloDetector", "postprocessEndToEnd");
     // End-to-end output: [1, maxDet, 6]
     // Each row = [x1, y1, x2, y2, score, class_id] in letterbox pixel coords
     std::vector<DetectionResult> results;
@@ -561,6 +680,7 @@ std::vector<int> YoloDetector::nms(
     const std::vector<DetectionResult>& boxes,
     float iouThreshold)
 {
+    TRACE_SCOPE("YoloDetector", "nms");
     if (boxes.empty()) return {};
 
     // Sort by confidence descending
@@ -3,6 +3,9 @@
 
 #include <onnxruntime_cxx_api.h>
 #include <QImage>
+#include <QString>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -39,12 +42,48 @@ enum class YoloVersion {
     // not as a separate version. End-to-end output shape: [1, maxDet, 6].
 };
 
+// Wall time of each stage of one detect() call.
+struct DetectorStageTimes {
+    double preprocessMs  = 0.0;  // letterbox, normalize, input tensor
+    double runMs         = 0.0;  // Session::Run
+    double postprocessMs = 0.0;  // decode output, confidence filter
+    double nmsMs         = 0.0;  // 0 for end-to-end models
+    int    candidates    = 0;    // boxes above the threshold, before NMS
+    int    kept          = 0;    // boxes returned
+};
+
+// Stage times of the last WINDOW detect() calls. Recording is a copy into a
+// ring buffer; percentiles are computed only when asked for.
+class DetectorStats {
+public:
+    static constexpr int WINDOW = 128;
+
+    void record(const DetectorStageTimes& t);
+    void reset();
+
+    bool     isEmpty() const { return m_size == 0; }
+    uint64_t calls() const   { return m_calls; }   // since load or reset
+    const DetectorStageTimes& last() const;
+    // Per-field percentile (p in [0,1]) over the window; each field is
+    // ranked on its own, so the result need not be one actual call.
+    DetectorStageTimes percentile(double p) const;
+
+private:
+    std::array<DetectorStageTimes, WINDOW> m_ring{};
+    int      m_size  = 0;
+    int      m_next  = 0;
+    uint64_t m_calls = 0;
+};
+
 class YoloDetector {
 public:
     YoloDetector();
     ~YoloDetector();
 
-    bool loadModel(const std::string& modelPath, std::string& errorMsg);
+    // intraOpThreads 0 lets one inference use every core; callers running
+    // several detectors in parallel pass their share.
+    bool loadModel(const std::string& modelPath, std::string& errorMsg,
+                   int intraOpThreads = 0);
 
     std::vector<DetectionResult> detect(
         const QImage& image,
@@ -52,6 +91,13 @@ public:
         float nmsIouThreshold = 0.45f
     );
 
+    // Decodes an image file for detect(). When the model is loaded the codec
+    // is asked for a size near the letterbox size (DCT-domain scaling for
+    // JPEG), so large photos are never decoded at full resolution. Scaling is
+    // uniform and detections are normalized to the decoded size, so the
+    // resulting boxes match those of a full-size decode.
+    QImage loadInputImage(const QString& path) const;
+
     bool isLoaded() const;
     bool isEndToEnd() const;
     int getNumClasses() const;
@@ -61,11 +107,23 @@ public:
     const YoloModelMetadata& getMetadata() const;
     const std::map<int, std::string>& getClassNames() const;
 
+    static float iou(const DetectionResult& a, const DetectionResult& b);
+
+    // Stage timings of recent detect() calls; cleared by loadModel().
+    const DetectorStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats.reset(); }
+
 #ifdef UNIT_TEST
     friend class TestYoloDetector;
+    friend class BenchDetector;
 #endif
 
 private:
+    // Letterbox scale and resized size of an image, shared by preprocess()
+    // and loadInputImage() so a pre-scaled decode is never resampled again.
+    float letterboxScale(int imgW, int imgH) const;
+    QSize letterboxSize(int imgW, int imgH) const;
+
     std::vector<float> preprocess(
         const QImage& image,
         float& scaleX, float& scaleY,
@@ -97,8 +155,6 @@ private:
         float iouThreshold
     );
 
-    static float iou(const DetectionResult& a, const DetectionResult& b);
-
     YoloVersion detectVersion();
     YoloVersion detectVersionFromMetadata(YoloVersion fallback);
 
@@ -130,6 +186,7 @@ private:
     YoloVersion m_version;
     bool m_loaded;
     YoloModelMetadata m_metadata;
+    DetectorStats m_stats;
 };
 
 #endif // YOLO_DETECTOR_H
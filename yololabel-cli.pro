@@ -0,0 +1,46 @@
+# Headless batch auto-labeler (no widgets). Needs ONNX Runtime.
+#
+#   qmake yololabel-cli.pro -o Makefile.cli "ONNXRUNTIME_DIR=$PWD/onnxruntime"
+#   make -f Makefile.cli
+
+QT       = core gui
+
+TARGET = yololabel-cli
+TEMPLATE = app
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000 ONNXRUNTIME_AVAILABLE
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# Chrome trace-event spans: qmake CONFIG+=trace (see trace.h)
+trace: DEFINES += YOLOLABEL_TRACE
+
+# Kept apart from YoloLabel's objects when both are built in one directory
+OBJECTS_DIR = .obj-cli
+
+SOURCES += \
+    yololabel_cli.cpp \
+    batch_labeler.cpp \
+    label_work_queue.cpp \
+    trace.cpp \
+    yolo_detector.cpp
+
+HEADERS += \
+    batch_labeler.h \
+    label_work_queue.h \
+    trace.h \
+    yolo_detector.h
+
+isEmpty(ONNXRUNTIME_DIR): ONNXRUNTIME_DIR = $$PWD/onnxruntime
+!exists($$ONNXRUNTIME_DIR/include): error("yololabel-cli needs ONNX Runtime; set ONNXRUNTIME_DIR")
+INCLUDEPATH += $$ONNXRUNTIME_DIR/include
+exists($$ONNXRUNTIME_DIR/include/onnxruntime) {
+    INCLUDEPATH += $$ONNXRUNTIME_DIR/include/onnxruntime
+}
+LIBS += -L$$ONNXRUNTIME_DIR/lib -lonnxruntime
+unix: QMAKE_RPATHDIR += $$ONNXRUNTIME_DIR/lib
+
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/YoloLabel/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,174 @@
+// Headless batch auto-labeler. Runs an ONNX YOLO model over an image
+// directory and writes YOLO .txt labels next to the images, without the GUI.
+// Several processes (or machines sharing the directory) can split a dataset
+// with --shard-index/--shard-count, or by all joining one --queue, which
+// hands out blocks of images as workers free up and re-issues the blocks
+// of workers that crash.
+//
+//   ./yololabel-cli --dir images --model yolo11n.onnx --threads 4
+//   ./yololabel-cli --dir /mnt/data --model m.onnx --shard-index 2 --shard-count 8
+//   ./yololabel-cli --dir /mnt/data --model m.onnx --queue    (on every node)
+//
+// The final stats are printed to stdout as one JSON object; progress lines
+// (--stats-interval) go to stderr, also as JSON.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QTextStream>
+#include <cstdio>
+#include <thread>
+
+#include "batch_labeler.h"
+#include "trace.h"
+
+static QJsonObject statsToJson(const BatchLabelStats& s, const BatchLabelOptions& o)
+{
+    const double wallSec = qMax<qint64>(1, s.wallMs) / 1000.0;
+    const int    done    = s.labeled + s.skipped + s.failed;
+    return QJsonObject{
+        { "shard_index",    o.shardIndex },
+        { "shard_count",    o.shardCount },
+        { "threads",        o.threads },
+        { "queue",          o.useQueue },
+        { "blocks",         s.blocks },
+        { "images",         s.images },
+        { "done",           done },
+        { "labeled",        s.labeled },
+        { "skipped",        s.skipped },
+        { "failed",         s.failed },
+        { "boxes",          double(s.boxes) },
+        { "wall_ms",        double(s.wallMs) },
+        { "images_per_sec", s.labeled / wallSec },
+        { "decode_ms",      double(s.decodeMs) },
+        { "infer_ms",       double(s.inferMs) },
+        { "write_ms",       double(s.writeMs) },
+    };
+}
+
+static int countLines(const QString& path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    int n = 0;
+    while (!f.atEnd())
+        if (!f.readLine().trimmed().isEmpty()) ++n;
+    return n;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("yololabel-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless YOLO batch auto-labeler");
+    parser.addHelpOption();
+    const QCommandLineOption dirOpt("dir", "Image directory to label.", "path");
+    const QCommandLineOption modelOpt("model", "ONNX YOLO detection model.", "file");
+    const QCommandLineOption classesOpt("classes",
+        "Class list (obj.names); if given, it must match the model's class count.", "file");
+    const QCommandLineOption confOpt("conf", "Confidence threshold (default 0.25).", "value", "0.25");
+    const QCommandLineOption iouOpt("iou", "NMS IoU threshold (default 0.45).", "value", "0.45");
+    const QCommandLineOption threadsOpt("threads",
+        "Detector threads (default: one per core).", "n",
+        QString::number(qMax(1u, std::thread::hardware_concurrency())));
+    const QCommandLineOption shardIndexOpt("shard-index", "This process's shard (default 0).", "i", "0");
+    const QCommandLineOption shardCountOpt("shard-count", "Number of shards (default 1).", "n", "1");
+    const QCommandLineOption skipOpt("skip-existing", "Leave images that already have a label file.");
+    const QCommandLineOption queueOpt("queue",
+        "Claim blocks of images from a work queue in the dataset directory, shared "
+        "with other processes labeling the same directory.");
+    const QCommandLineOption blockSizeOpt("block-size",
+        QString("Images per queue block (default %1).").arg(LabelWorkQueue::DEFAULT_BLOCK_SIZE),
+        "n", QString::number(LabelWorkQueue::DEFAULT_BLOCK_SIZE));
+    const QCommandLineOption leaseOpt("lease",
+        QString("Seconds before a silent worker's claim expires (default %1).")
+            .arg(LabelWorkQueue::DEFAULT_LEASE_MS / 1000),
+        "s", QString::number(LabelWorkQueue::DEFAULT_LEASE_MS / 1000));
+    const QCommandLineOption workerOpt("worker-id",
+        "Name of this worker in queue claims (default host:pid).", "id");
+    const QCommandLineOption intervalOpt("stats-interval",
+        "Print progress to stderr every N ms (default 0: off).", "ms", "0");
+    parser.addOptions({ dirOpt, modelOpt, classesOpt, confOpt, iouOpt, threadsOpt,
+                        shardIndexOpt, shardCountOpt, skipOpt, queueOpt, blockSizeOpt,
+                        leaseOpt, workerOpt, intervalOpt });
+    parser.process(app);
+
+    if (!parser.isSet(dirOpt) || !parser.isSet(modelOpt)) {
+        std::fprintf(stderr, "--dir and --model are required.\n\n%s",
+                     qPrintable(parser.helpText()));
+        return 2;
+    }
+
+    BatchLabelOptions options;
+    options.imageDir        = parser.value(dirOpt);
+    options.modelPath       = parser.value(modelOpt);
+    options.confThreshold   = parser.value(confOpt).toFloat();
+    options.nmsIouThreshold = parser.value(iouOpt).toFloat();
+    options.threads         = qMax(1, parser.value(threadsOpt).toInt());
+    options.shardIndex      = parser.value(shardIndexOpt).toInt();
+    options.shardCount      = qMax(1, parser.value(shardCountOpt).toInt());
+    options.skipExisting    = parser.isSet(skipOpt);
+    options.useQueue        = parser.isSet(queueOpt);
+    options.queueBlockSize  = qMax(1, parser.value(blockSizeOpt).toInt());
+    options.queueLeaseMs    = qMax(1, parser.value(leaseOpt).toInt()) * qint64(1000);
+    options.workerId        = parser.value(workerOpt);
+
+    if (options.useQueue && (parser.isSet(shardIndexOpt) || parser.isSet(shardCountOpt))) {
+        std::fprintf(stderr, "--queue balances the whole dataset across workers; "
+                             "it cannot be combined with --shard-index/--shard-count.\n");
+        return 2;
+    }
+    if (options.shardIndex < 0 || options.shardIndex >= options.shardCount) {
+        std::fprintf(stderr, "--shard-index must be in [0, %d).\n", options.shardCount);
+        return 2;
+    }
+
+    BatchAutoLabeler labeler(options);
+    QString error;
+    if (!labeler.loadModels(&error)) {
+        std::fprintf(stderr, "Failed to load model: %s\n", qPrintable(error));
+        return 1;
+    }
+
+    if (parser.isSet(classesOpt)) {
+        const int listed = countLines(parser.value(classesOpt));
+        if (listed != labeler.numClasses()) {
+            std::fprintf(stderr, "Class list has %d classes but the model has %d.\n",
+                         listed, labeler.numClasses());
+            return 1;
+        }
+    }
+
+    // Progress is reported from worker threads; throttle it to the interval
+    const qint64 interval = parser.value(intervalOpt).toLongLong();
+    QElapsedTimer sinceReport;
+    sinceReport.start();
+    QMutex reportMutex;
+    BatchAutoLabeler::Progress progress;
+    if (interval > 0) {
+        progress = [&](const BatchLabelStats& s) {
+            QMutexLocker lock(&reportMutex);
+            if (sinceReport.elapsed() < interval) return;
+            sinceReport.restart();
+            std::fprintf(stderr, "%s\n", QJsonDocument(statsToJson(s, options))
+                                             .toJson(QJsonDocument::Compact).constData());
+        };
+    }
+
+    const BatchLabelStats stats = labeler.run(progress);
+
+    QTextStream out(stdout);
+    out << QJsonDocument(statsToJson(stats, options)).toJson(QJsonDocument::Compact) << "\n";
+
+#ifdef YOLOLABEL_TRACE
+    const QString tracePath = Trace::defaultPath();
+    if (Trace::writeJson(tracePath))
+        std::fprintf(stderr, "Trace written to %s\n", qPrintable(tracePath));
+#endif
+    return stats.failed > 0 ? 1 : 0;
+}